@@ -21,6 +21,20 @@
  */
 #define ATTRIBUTE_ALIGNED __attribute__((aligned(__BIGGEST_ALIGNMENT__)))
 
+/**
+ * @def CACHE_LINE_SIZE
+ * The size, in bytes, of a cache line. Data written by different
+ * threads should be at least this far apart to avoid false sharing
+ */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * @def ATTRIBUTE_CACHE_ALIGNED
+ * An attribute to tell the compiler to align a data
+ * type to the start of a cache line
+ */
+#define ATTRIBUTE_CACHE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+
 /**
  * Return 'offset' incremented by the amount required to
  * align 'offset' to the byte boundary 'alignment'
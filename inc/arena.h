@@ -19,25 +19,111 @@ typedef struct _arena_block_s
     struct _arena_block_s *next;
     Byte_t *start;
     Byte_t *end;
+
+    /** Memory from 'touched' to 'end' has never been handed out, and is still zero */
+    Byte_t *touched;
 } ArenaBlock_t;
 
 /**
  * @private
  * @def ARENA_BLOCK_SIZE
- * Size of arena block when allocated. When the block is full
- * a new block will be allocated using 'malloc().' When an
- * allocation is larger than ARENA_BLOCK_SIZE, a special block,
+ * Size of the first arena block when allocated. When the block
+ * is full a new block will be allocated using 'malloc().' When an
+ * allocation is larger than the next block size, a special block,
  * large enough for the allocation, will be malloc'd
  */
 #define ARENA_BLOCK_SIZE 4096
 
+/**
+ * @private
+ * @def ARENA_BLOCK_MAX_SIZE
+ * Each new block is twice the size of the one before it, until
+ * the block size reaches ARENA_BLOCK_MAX_SIZE
+ */
+#define ARENA_BLOCK_MAX_SIZE (ARENA_BLOCK_SIZE << 8)
+
 /**
  * @private
  * @def ARENA_BLOCK_MAX_MEM
- * The maxium amount of free memory that could be in an
- * arena.
+ * The maximum amount of free memory that could be in one
+ * standard arena block. A block's header is allocated on
+ * top of its usable size, so this is the largest block size
+ */
+#define ARENA_BLOCK_MAX_MEM ARENA_BLOCK_MAX_SIZE
+
+/**
+ * @private
+ * @def ARENA_CACHE_CLASSES
+ * The number of block sizes kept in the block cache. Blocks of
+ * ARENA_BLOCK_SIZE, doubling up to ARENA_BLOCK_MAX_SIZE, are cached
+ */
+#define ARENA_CACHE_CLASSES 9
+
+/**
+ * @private
+ * @def ARENA_CACHE_SHARDS
+ * The number of shards in the block cache. Each thread is given a
+ * shard, so that threads rarely contend for the same one
+ */
+#define ARENA_CACHE_SHARDS 16
+
+/**
+ * @private
+ * @def ARENA_CACHE_SHARD_SIZE
+ * The most memory, in bytes, that one shard of the block cache
+ * will hold. Blocks released past this are returned to the system
+ */
+#define ARENA_CACHE_SHARD_SIZE (ARENA_BLOCK_MAX_SIZE * 4)
+
+/**
+ * @private
+ * @def ARENA_CHUNK_SIZE
+ * Size of the chunks that each thread bump-allocates from
+ * in a concurrent arena. Allocations larger than a quarter
+ * of a chunk get a block of their own
+ */
+#define ARENA_CHUNK_SIZE (ARENA_BLOCK_SIZE * 16)
+
+/**
+ * @private
+ * @def ARENA_THREAD_SLOTS
+ * The number of concurrent arenas a thread can hold a
+ * chunk in at once. Arenas that hash to the same slot
+ * take turns, wasting the rest of the evicted chunk
+ */
+#define ARENA_THREAD_SLOTS 8
+
+/**
+ * @private
+ * @def ARENA_COMMIT_SIZE
+ * The smallest amount of memory a virtual arena will commit
+ * at once, when its bump pointer moves past committed memory
+ */
+#define ARENA_COMMIT_SIZE (ARENA_BLOCK_SIZE * 16)
+
+/**
+ * @private
+ * @def ARENA_HUGE_PAGE_SIZE
+ * The size of a transparent huge page. Virtual arenas using
+ * huge pages are aligned to, and commit in multiples of, this size
+ */
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * @private
+ * How an arena gets its memory
  */
-#define ARENA_BLOCK_MAX_MEM (ARENA_BLOCK_SIZE - sizeof(ArenaBlock_t))
+typedef enum _arena_kind_e
+{
+    /** A chain of malloc'd blocks, only usable from one thread at a time */
+    ARENA_BLOCKS = 0,
+
+    /** Each thread allocates from its own chunk, chunks are shared lock-free */
+    ARENA_CONCURRENT,
+
+    /** One contiguous block, committed from a reserved virtual address range */
+    ARENA_VIRTUAL,
+} ArenaKind_t;
 
 /**
  * @class Arena_t
@@ -48,9 +134,93 @@ typedef struct _arena_block_s
  */
 typedef struct _arena_s
 {
+    /** The first block in the arena */
     ArenaBlock_t *blocks;
+
+    /** The block that allocations are currently made from */
+    ArenaBlock_t *current;
+
+    /** The size of the next block to be allocated */
+    Unsigned_t next_block_size;
+
+    /** How this arena gets its memory */
+    ArenaKind_t kind;
+
+    /** Tells a concurrent arena apart from earlier arenas at the same address */
+    Unsigned_t generation;
+
+    /** The end of the address range reserved by a virtual arena */
+    Byte_t *reserve_end;
+
+    /** The granularity a virtual arena commits memory in */
+    Unsigned_t commit_size;
+
+    /** The number of allocations made against this arena */
+    Unsigned_t allocations;
+
+    /** The total number of bytes asked for by allocations against this arena */
+    Unsigned_t bytes_requested;
+
+    /** Bytes handed out from the blocks before the current one */
+    Unsigned_t retired_used;
+
+    /** The most bytes this arena has had handed out at once, as of the last rewind */
+    Unsigned_t high_water;
 } Arena_t;
 
+/**
+ * @class ArenaStats_t
+ * @brief A snapshot of how an arena is using its memory
+ *
+ * Returned by ArenaStats, or by ArenaGlobalStats for the
+ * whole process
+ */
+typedef struct _arena_stats_s
+{
+    /** @brief The number of allocations made */
+    Unsigned_t allocations;
+
+    /** @brief The total number of bytes asked for by allocations */
+    Unsigned_t bytes_requested;
+
+    /** @brief The total size of the blocks held */
+    Unsigned_t bytes_reserved;
+
+    /**
+     * @brief Bytes handed out from the blocks held, including
+     * the padding added to align allocations
+     */
+    Unsigned_t bytes_used;
+
+    /**
+     * @brief Space left unused at the end of blocks that
+     * the arena has moved on from
+     */
+    Unsigned_t bytes_wasted;
+
+    /** @brief The number of blocks held */
+    Unsigned_t block_count;
+
+    /**
+     * @brief The most bytes that have been in use at once. For
+     * ArenaGlobalStats, the most bytes that have been reserved at once
+     */
+    Unsigned_t high_water;
+} ArenaStats_t;
+
+/**
+ * @class ArenaMark_t
+ * @brief A savepoint within an arena
+ *
+ * Created by ArenaMark, and passed to ArenaRewind to
+ * free everything allocated after the savepoint
+ */
+typedef struct _arena_mark_s
+{
+    ArenaBlock_t *block;
+    Byte_t *position;
+} ArenaMark_t;
+
 /**
  * The permanent arena. This arena will be
  * initialized on program startup, and deconstructed
@@ -74,21 +244,65 @@ static Arena_t ARENA_NONE = {(void *)-1};
  */
 void ConstructArena(Arena_t *a);
 
+/**
+ * @public @memberof Arena_t
+ *
+ * Initialize the given arena so that it may be allocated
+ * against from several threads at once. Each thread bump
+ * allocates from a chunk of its own, and only touches state
+ * shared with other threads when it needs a new chunk.
+ *
+ * ArenaMark, ArenaRewind and ArenaReset may not be used on
+ * a concurrent arena. DeconstructArena frees the memory of
+ * every thread at once, and must only be called after all
+ * threads have stopped allocating against the arena
+ *
+ * @param a The arena to initialize
+ */
+void ConstructConcurrentArena(Arena_t *a);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Initialize the given arena over a single reserved range
+ * of virtual memory. Pages are only committed as allocations
+ * reach them, so 'reserve' may be far larger than the memory
+ * that will actually be used. Everything allocated against
+ * the arena is contiguous, and never moves.
+ *
+ * Allocating past the end of the reserved range is an error
+ *
+ * @param a The arena to initialize
+ * @param reserve The number of bytes of address space to reserve
+ * @param huge_pages Ask the kernel to back the arena with
+ * transparent huge pages, to reduce TLB misses for large working sets.
+ * The first allocation is then aligned to ARENA_HUGE_PAGE_SIZE
+ */
+void ConstructVirtualArena(Arena_t *a, Unsigned_t reserve, Boolean_t huge_pages);
+
 /**
  * @public @memberof Arena_t
  *
  * Cleanup the given arena. Free the associated
- * memory blocks
+ * memory blocks. Blocks of standard sizes are kept
+ * in a process-wide cache, to be reused by arenas
+ * constructed later on, instead of being free'd
  *
  * @param a The arena to cleanup
  */
 void DeconstructArena(Arena_t *a);
 
+/**
+ * Return every block held by the process-wide block
+ * cache to the system
+ */
+void FlushArenaBlockCache();
+
 /**
  * @public @memberof Arena_t
  *
- * Allocate a buffer of length 'size' to an arena. If
- * the arena is ARENA_NONE, then simply use 'malloc()'
+ * Allocate a zeroed buffer of length 'size' to an arena. If
+ * the arena is ARENA_NONE, then simply use 'calloc()'
  * from the standard library
  *
  * @param a The arena to allocate to
@@ -96,4 +310,148 @@ void DeconstructArena(Arena_t *a);
  */
 void *ArenaAllocate(Arena_t *a, Unsigned_t size);
 
+/**
+ * @public @memberof Arena_t
+ *
+ * Allocate a buffer of length 'size' to an arena, without
+ * zeroing it. Use when the caller will overwrite the whole
+ * buffer anyway. If the arena is ARENA_NONE, then simply
+ * use 'malloc()' from the standard library
+ *
+ * @param a The arena to allocate to
+ * @param size The length of the allocated buffer
+ */
+void *ArenaAllocateUninit(Arena_t *a, Unsigned_t size);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Allocate a zeroed buffer of length 'size' to an arena, starting
+ * on an 'alignment' byte boundary. Useful for SIMD data, or for
+ * giving objects shared between threads a cache line of their own.
+ * If the arena is ARENA_NONE, then use 'posix_memalign()'
+ *
+ * @param a The arena to allocate to
+ * @param size The length of the allocated buffer
+ * @param alignment The byte boundary to align to. Must be a power of two
+ */
+void *ArenaAllocateAligned(Arena_t *a, Unsigned_t size, Unsigned_t alignment);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Change the size of a buffer allocated against an arena. If
+ * 'ptr' is the most recent allocation in the arena, and there is
+ * room, it is grown or shrunk in place. Otherwise the contents
+ * are copied into a new allocation. Bytes past 'old_size' are
+ * zeroed. If the arena is ARENA_NONE, then simply use 'realloc()'
+ *
+ * @param a The arena 'ptr' was allocated against
+ * @param ptr The buffer to resize. If NULL, a new buffer is allocated
+ * @param old_size The current length of the buffer
+ * @param new_size The length to resize the buffer to
+ */
+void *ArenaReallocate(Arena_t *a, void *ptr, Unsigned_t old_size, Unsigned_t new_size);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Try to grow or shrink a buffer without moving it. This only
+ * succeeds if 'ptr' is the most recent allocation in the arena,
+ * and there is room. Bytes past 'old_size' are zeroed. Always
+ * fails if the arena is ARENA_NONE or a concurrent arena
+ *
+ * @param a The arena 'ptr' was allocated against
+ * @param ptr The buffer to resize
+ * @param old_size The current length of the buffer
+ * @param new_size The length to resize the buffer to
+ * @return true if the buffer now has length 'new_size'
+ */
+Boolean_t ArenaResizeInPlace(Arena_t *a, void *ptr, Unsigned_t old_size, Unsigned_t new_size);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Record the current position of an arena, so that later
+ * allocations can be rolled back with ArenaRewind
+ *
+ * @param a The arena to mark
+ */
+ArenaMark_t ArenaMark(Arena_t *a);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Free everything allocated against an arena since 'mark'
+ * was taken. The arena's blocks are kept, so allocations made
+ * after rewinding reuse them rather than calling 'malloc()'.
+ * Marks must be rewound in the reverse order they were taken.
+ * Anything that keeps memory from the arena, such as a Pool_t,
+ * must not use it again once it has been rewound
+ *
+ * Example usage for per-request scratch memory:
+ * @code
+ *  ArenaMark_t mark = ArenaMark(&scratch);
+ *  HandleRequest(&scratch, request);
+ *  ArenaRewind(&scratch, mark);
+ * @endcode
+ *
+ * @param a The arena to rewind
+ * @param mark The savepoint to rewind to
+ */
+void ArenaRewind(Arena_t *a, ArenaMark_t mark);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Free everything allocated against an arena, but keep
+ * its blocks so they can be reused by later allocations
+ * without calling 'malloc()'. Pools using the arena must be
+ * reset with PoolReset before they are used again
+ *
+ * @param a The arena to reset
+ */
+void ArenaReset(Arena_t *a);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Free everything allocated against an arena, keeping
+ * at most 'retain' bytes of blocks for reuse. Any blocks
+ * past that are returned to the block cache or the system,
+ * or decommitted for a virtual arena. Lets an arena give
+ * back the memory from a one-off spike in usage. Pools
+ * using the arena must be reset with PoolReset before
+ * they are used again
+ *
+ * @param a The arena to reset
+ * @param retain The number of bytes of blocks to keep
+ */
+void ArenaResetTrim(Arena_t *a, Unsigned_t retain);
+
+/**
+ * @public @memberof Arena_t
+ *
+ * Report how an arena is using its memory. Takes time
+ * proportional to the number of blocks in the arena.
+ *
+ * Concurrent arenas do not count allocations or wasted
+ * space, and may only be queried while no thread is
+ * allocating against them. ARENA_NONE reports nothing
+ *
+ * @param a The arena to report on
+ */
+ArenaStats_t ArenaStats(Arena_t *a);
+
+#ifdef ARENA_STATS
+/**
+ * Report the number of allocations, bytes requested and bytes
+ * reserved from the system across every arena in the process.
+ * Only available when the library is built with ARENA_STATS
+ * defined, since keeping the counters costs an atomic add per
+ * allocation
+ */
+ArenaStats_t ArenaGlobalStats();
+#endif
+
 #endif
\ No newline at end of file
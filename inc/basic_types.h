@@ -43,4 +43,20 @@ typedef ssize_t Signed_t;
  */
 typedef bool Boolean_t;
 
+/**
+ * @class Comparator_t
+ * Orders two elements, in the same way as the comparison
+ * function taken by 'qsort()'. Returns a negative number if
+ * 'a' comes before 'b', a positive number if it comes after,
+ * and zero if they are equal
+ */
+typedef int (*Comparator_t)(const void *a, const void *b);
+
+/**
+ * @class Predicate_t
+ * Tests a single element. 'context' is passed through
+ * unchanged from the caller, for any state the test needs
+ */
+typedef Boolean_t (*Predicate_t)(const void *element, void *context);
+
 #endif
\ No newline at end of file
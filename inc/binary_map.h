@@ -11,6 +11,7 @@
 #include <stdbool.h>
 
 #include "arena.h"
+#include "pool.h"
 #include "iterator.h"
 
 /**
@@ -88,6 +89,12 @@ typedef struct _map_node_s
     Byte_t value[];
 } MapNode_t;
 
+/**
+ * @def MAP_NODE_SIZE
+ * The total size of a map node with a value of length 'LENGTH'
+ */
+#define MAP_NODE_SIZE(LENGTH) (sizeof(MapNode_t) + (LENGTH))
+
 /**
  * @class Map_t
  * @brief A key-value store implemented using
@@ -109,6 +116,22 @@ typedef struct _map_s
  */
 MapNode_t *NewMapNode(Arena_t *arena, MapKey_t key, void *value, Unsigned_t length);
 
+/**
+ * @public @memberof MapNode_t
+ * @brief Create new map node in a slot taken from a pool
+ *
+ * Behaves like NewMapNode, but the node can be given back
+ * to the pool with PoolFree once it has been taken out of
+ * its map with RemoveMapNode
+ *
+ * @param pool The pool to take the node from. Its slots must be
+ * at least MAP_NODE_SIZE(length) bytes
+ * @param key The key for the new key-value pair
+ * @param value The value to be stored in the node
+ * @param length The length, in bytes, of the value to be stored in the node
+ */
+MapNode_t *NewPooledMapNode(Pool_t *pool, MapKey_t key, void *value, Unsigned_t length);
+
 /**
  * @public @memberof MapNode_t
  * @brief Copy a value into a map node
@@ -155,6 +178,19 @@ bool ExistsInMap(Map_t *map, MapKey_t key);
  */
 void InsertMapNode(Map_t *map, MapNode_t *node);
 
+/**
+ * @public @memberof Map_t
+ * @brief Take the node with a given key out of a map
+ *
+ * The node itself is not free'd. Nodes made by NewPooledMapNode
+ * can be given back to their pool with PoolFree
+ *
+ * @param map The map to modify
+ * @param key The key of the node to remove
+ * @return The removed node, or NULL if the key is not in the map
+ */
+MapNode_t *RemoveMapNode(Map_t *map, MapKey_t key);
+
 /**
  * @public @memberof Map_t
  * @brief Balance the map's internal binary tree
@@ -0,0 +1,133 @@
+#ifndef __LIB_FUNDEMENTAL_BOUNDED_QUEUE_H__
+#define __LIB_FUNDEMENTAL_BOUNDED_QUEUE_H__
+
+/**
+ * @file bounded_queue.h
+ * Lock-free queue that any number of threads may
+ * push to and pop from at once
+ */
+
+#include "fixed_buffer.h"
+#include "alignment.h"
+
+/**
+ * @private
+ * @def BOUNDED_QUEUE_SPIN_LIMIT
+ * The number of times a blocking push or pop retries
+ * before it starts yielding the processor between retries
+ */
+#define BOUNDED_QUEUE_SPIN_LIMIT 64
+
+/**
+ * @class BoundedQueue_t
+ * @brief A bounded multi-producer, multi-consumer queue
+ *
+ * Every slot holds a sequence number next to its element. A slot's
+ * sequence number says whether it is waiting to be pushed to or
+ * popped from for the current lap of the queue, so threads claim
+ * slots with a single compare-and-swap on the push or pop index, and
+ * never wait on a lock. The slots are kept in a Buffer_t whose length
+ * is a power of two.
+ *
+ * Queues allocated against an arena should be allocated with
+ * ArenaAllocateAligned, aligned to CACHE_LINE_SIZE
+ */
+typedef struct _bounded_queue_s
+{
+    /**
+     * @memberof BoundedQueue_t
+     * @brief The arena the slots are allocated against
+     */
+    Arena_t *arena;
+
+    /**
+     * @memberof BoundedQueue_t
+     * @brief The slots of the queue. Its length is
+     * the capacity of the queue
+     */
+    Buffer_t *slots;
+
+    /**
+     * @memberof BoundedQueue_t
+     * @brief Length, in bytes, of a single element in the queue
+     */
+    Unsigned_t data_width;
+
+    /** Length of the slots buffer minus one, to turn indices into positions */
+    Unsigned_t mask;
+
+    /** The index of the next slot to push to */
+    Unsigned_t push_index ATTRIBUTE_CACHE_ALIGNED;
+
+    /** The index of the next slot to pop from */
+    Unsigned_t pop_index ATTRIBUTE_CACHE_ALIGNED;
+} BoundedQueue_t;
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Initialize an empty queue
+ *
+ * @param q The queue to initialize
+ * @param a The arena to allocate the slots against. Against
+ * ARENA_NONE the queue must be cleaned up with
+ * DeconstructBoundedQueue
+ * @param data_width The width of a single element
+ * @param capacity The number of elements the queue can hold.
+ * It is rounded up to a power of two, of at least 2
+ */
+void ConstructBoundedQueue(BoundedQueue_t *q, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity);
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Free the slots of a queue allocated against
+ * ARENA_NONE. Does nothing for other arenas
+ *
+ * @param q The queue to deconstruct
+ */
+void DeconstructBoundedQueue(BoundedQueue_t *q);
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Copy an element onto the back of a queue,
+ * unless it is full
+ *
+ * @param q The queue to push onto
+ * @param data The element to copy in
+ * @return false if the queue was full
+ */
+Boolean_t BoundedQueueTryPush(BoundedQueue_t *q, void *data);
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Copy an element off the front of a queue,
+ * unless it is empty
+ *
+ * @param q The queue to pop from
+ * @param dest Where to copy the element to
+ * @return false if the queue was empty
+ */
+Boolean_t BoundedQueueTryPop(BoundedQueue_t *q, void *dest);
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Copy an element onto the back of a queue,
+ * waiting for room if it is full. The thread spins
+ * for a short while, then yields between retries
+ *
+ * @param q The queue to push onto
+ * @param data The element to copy in
+ */
+void BoundedQueuePush(BoundedQueue_t *q, void *data);
+
+/**
+ * @public @memberof BoundedQueue_t
+ * @brief Copy an element off the front of a queue,
+ * waiting for one to be pushed if it is empty. The
+ * thread spins for a short while, then yields between retries
+ *
+ * @param q The queue to pop from
+ * @param dest Where to copy the element to
+ */
+void BoundedQueuePop(BoundedQueue_t *q, void *dest);
+
+#endif
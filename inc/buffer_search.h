@@ -0,0 +1,121 @@
+#ifndef __LIB_FUNDEMENTAL_BUFFER_SEARCH_H__
+#define __LIB_FUNDEMENTAL_BUFFER_SEARCH_H__
+
+/**
+ * @file buffer_search.h
+ * Searching the elements of a buffer. Linear scans compare
+ * many bytes at once with SSE2, or AVX2 where the processor
+ * supports it, and searches of sorted buffers avoid branching
+ * on each comparison
+ */
+
+#include "fixed_buffer.h"
+
+/**
+ * @private
+ * @def SEARCH_PREFETCH_DISTANCE
+ * How many levels ahead of the current node an Eytzinger
+ * search prefetches. Each level down doubles the index, so
+ * this many levels is 2^SEARCH_PREFETCH_DISTANCE nodes ahead
+ */
+#define SEARCH_PREFETCH_DISTANCE 4
+
+/**
+ * Find the first occurrence of a byte in a region of memory,
+ * in the same way as 'memchr()'
+ *
+ * @param data The memory to search
+ * @param length The number of bytes to search
+ * @param byte The byte to find
+ * @return A pointer to the first matching byte, or NULL
+ * if there is none
+ */
+Byte_t *RawByteFind(Byte_t *data, Unsigned_t length, Byte_t byte);
+
+/**
+ * Count the occurrences of a byte in a region of memory
+ *
+ * @param data The memory to search
+ * @param length The number of bytes to search
+ * @param byte The byte to count
+ */
+Unsigned_t RawByteCount(Byte_t *data, Unsigned_t length, Byte_t byte);
+
+/**
+ * @public @memberof Buffer_t
+ * Find the first element of a buffer equal to a value.
+ * Elements are compared byte by byte, so padding within
+ * elements must be consistent
+ *
+ * @param b The buffer to search
+ * @param value A pointer to the value to find. It is data_width bytes long
+ * @return A pointer to the first matching element, or NULL
+ * if there is none
+ */
+void *BufferFind(Buffer_t *b, void *value);
+
+/**
+ * @public @memberof Buffer_t
+ * Count the elements of a buffer equal to a value. Elements
+ * are compared byte by byte, in the same way as BufferFind
+ *
+ * @param b The buffer to search
+ * @param value A pointer to the value to count
+ */
+Unsigned_t BufferCount(Buffer_t *b, void *value);
+
+/**
+ * @public @memberof Buffer_t
+ * Find the first element of a sorted buffer that is not less
+ * than a value, with a binary search that does not branch on
+ * the result of each comparison
+ *
+ * @param b The buffer to search, sorted in ascending order
+ * @param value A pointer to the value to search for
+ * @param compare The function the buffer was sorted with
+ * @return The index of the first element not less than 'value',
+ * or the length of the buffer if every element is less
+ */
+Unsigned_t BufferLowerBound(Buffer_t *b, void *value, Comparator_t compare);
+
+/**
+ * @public @memberof Buffer_t
+ * BufferLowerBound for a buffer of unsigned integers. The
+ * comparison is made inline, rather than through a function
+ *
+ * @param b The buffer to search, sorted in ascending order. Its data_width
+ * must be 1, 2, 4 or 8, and its elements are read as unsigned integers
+ * @param key The value to search for
+ * @return The index of the first element not less than 'key',
+ * or the length of the buffer if every element is less
+ */
+Unsigned_t BufferLowerBoundUnsigned(Buffer_t *b, Unsigned_t key);
+
+/**
+ * @public @memberof Buffer_t
+ * Copy a sorted buffer into Eytzinger order, where the children of
+ * the element at index k are at 2k and 2k + 1. A search walks down
+ * the tree touching one cache line per level, and the next levels
+ * can be prefetched, so large buffers are searched much faster
+ * than with a plain binary search. The element at index 0 is unused
+ *
+ * @param a The arena to allocate the new buffer against
+ * @param sorted The buffer to copy, sorted in ascending order
+ * @return A buffer one element longer than 'sorted'
+ */
+Buffer_t *NewEytzingerBuffer(Arena_t *a, Buffer_t *sorted);
+
+/**
+ * @public @memberof Buffer_t
+ * Find the first element of a buffer in Eytzinger order that
+ * is not less than a value
+ *
+ * @param eytzinger A buffer made by NewEytzingerBuffer
+ * @param value A pointer to the value to search for
+ * @param compare The function the original buffer was sorted with
+ * @return A pointer to the first element not less than 'value',
+ * or NULL if every element is less
+ */
+void *EytzingerLowerBound(Buffer_t *eytzinger, void *value, Comparator_t compare);
+
+#endif
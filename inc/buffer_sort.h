@@ -0,0 +1,75 @@
+#ifndef __LIB_FUNDEMENTAL_BUFFER_SORT_H__
+#define __LIB_FUNDEMENTAL_BUFFER_SORT_H__
+
+/**
+ * @file buffer_sort.h
+ * In-place sorting of the elements in a buffer
+ */
+
+#include "fixed_buffer.h"
+
+/**
+ * @private
+ * @def BUFFER_SORT_INSERTION_THRESHOLD
+ * Runs of this many elements or fewer are sorted
+ * with an insertion sort, which beats partitioning
+ * or merging on very short runs
+ */
+#define BUFFER_SORT_INSERTION_THRESHOLD 16
+
+/**
+ * @private
+ * @def BUFFER_RADIX_BITS
+ * The number of bits of the key sorted on by each
+ * pass of a radix sort
+ */
+#define BUFFER_RADIX_BITS 8
+
+/**
+ * @public @memberof Buffer_t
+ * Sort the elements of a buffer. This is an introsort, so it
+ * runs in O(n log n) time even on adversarial input. The sort
+ * is not stable
+ *
+ * @param b The buffer to sort
+ * @param compare The function used to order the elements
+ */
+void BufferSort(Buffer_t *b, Comparator_t compare);
+
+/**
+ * @public @memberof BufferSlice_t
+ * Sort the elements within a slice, in the same way as BufferSort
+ *
+ * @param s The slice to sort
+ * @param compare The function used to order the elements
+ */
+void BufferSliceSort(BufferSlice_t *s, Comparator_t compare);
+
+/**
+ * @public @memberof Buffer_t
+ * Sort the elements of a buffer, keeping elements that compare
+ * equal in the order they started in. This is a merge sort,
+ * and needs scratch space for a copy of the buffer
+ *
+ * @param b The buffer to sort
+ * @param compare The function used to order the elements
+ * @param scratch The arena to take scratch space from. It is
+ * rewound before returning, so must not be a concurrent arena
+ */
+void BufferStableSort(Buffer_t *b, Comparator_t compare, Arena_t *scratch);
+
+/**
+ * @public @memberof Buffer_t
+ * Sort a buffer of unsigned integers into ascending order, with
+ * a least significant digit radix sort. This runs in linear time,
+ * and is much faster than a comparison sort on large buffers.
+ * The sort is stable
+ *
+ * @param b The buffer to sort. Its data_width must be 1, 2, 4 or 8,
+ * and its elements are read as unsigned integers of that width
+ * @param scratch The arena to take scratch space from. It is
+ * rewound before returning, so must not be a concurrent arena
+ */
+void BufferRadixSort(Buffer_t *b, Arena_t *scratch);
+
+#endif
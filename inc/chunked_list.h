@@ -0,0 +1,153 @@
+#ifndef __LIB_FUNDEMENTAL_CHUNKED_LIST_H__
+#define __LIB_FUNDEMENTAL_CHUNKED_LIST_H__
+
+/**
+ * @file chunked_list.h
+ * An unrolled linked list, which packs many fixed-width
+ * elements into each node
+ */
+
+#include "arena.h"
+#include "pool.h"
+#include "iterator.h"
+#include "alignment.h"
+
+/**
+ * @private
+ * @def CHUNKED_LIST_CHUNK_SIZE
+ * The size, in bytes, of a single chunk of a chunked list, header
+ * included. Chunks holding elements wider than this hold just one
+ * element, and are rounded up to a multiple of CACHE_LINE_SIZE.
+ * Every chunk starts on a cache line
+ */
+#define CHUNKED_LIST_CHUNK_SIZE (CACHE_LINE_SIZE * 4)
+
+/**
+ * @private
+ * A node of a chunked list. The elements in use sit contiguously,
+ * starting at slot 'start'. Free slots are kept on both ends, so
+ * elements can be added to either end without moving the others
+ */
+typedef struct _list_chunk_s
+{
+    struct _list_chunk_s *next;
+    struct _list_chunk_s *previous;
+    Unsigned_t start;
+    Unsigned_t count;
+    Byte_t data[];
+} ListChunk_t;
+
+/**
+ * @class ChunkedList_t
+ * @brief A list of fixed-width elements, stored many to a node
+ *
+ * Chunks form a circular, doubly-linked list, like List_t nodes do.
+ * Each chunk holds as many elements as fit in CHUNKED_LIST_CHUNK_SIZE
+ * bytes, so there is one allocation and one header per chunk, rather
+ * than per element, and iterating walks through contiguous memory.
+ * The number of elements is kept up to date, so the length of the
+ * list is known without walking it. Emptied chunks are kept in a
+ * pool, and reused as the list grows again
+ */
+typedef struct _chunked_list_s
+{
+    /**
+     * @memberof ChunkedList_t
+     * @brief Length, in bytes, of a single element in the list
+     */
+    Unsigned_t data_width;
+
+    /**
+     * @memberof ChunkedList_t
+     * @brief The number of elements in the list
+     */
+    Unsigned_t length;
+
+    /** The number of elements that fit in a chunk */
+    Unsigned_t chunk_capacity;
+
+    /** The chunk holding the first element */
+    ListChunk_t *first_chunk;
+
+    /** Where chunks are allocated from */
+    Pool_t chunks;
+} ChunkedList_t;
+
+/**
+ * @public @memberof ChunkedList_t
+ * Initialize an empty chunked list
+ *
+ * @param list The list to initialize
+ * @param arena The arena to allocate chunks against. Must not be
+ * ARENA_NONE, since the chunks would never be free'd
+ * @param data_width The width of a single element
+ */
+void ConstructChunkedList(ChunkedList_t *list, Arena_t *arena, Unsigned_t data_width);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Copy an element onto the end of a list
+ *
+ * @param list The list to modify
+ * @param data The element to copy in. If it is NULL, the
+ * new element is left uninitialized
+ * @return A pointer to the new element
+ */
+void *ChunkedListInsertBack(ChunkedList_t *list, void *data);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Copy an element onto the front of a list
+ *
+ * @param list The list to modify
+ * @param data The element to copy in. If it is NULL, the
+ * new element is left uninitialized
+ * @return A pointer to the new element
+ */
+void *ChunkedListInsertFront(ChunkedList_t *list, void *data);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Remove the element at the end of a list
+ *
+ * @param list The list to modify. Must not be empty
+ * @param dest Where to copy the removed element to. May be NULL
+ */
+void ChunkedListRemoveBack(ChunkedList_t *list, void *dest);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Remove the element at the front of a list
+ *
+ * @param list The list to modify. Must not be empty
+ * @param dest Where to copy the removed element to. May be NULL
+ */
+void ChunkedListRemoveFront(ChunkedList_t *list, void *dest);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Get the number of elements in a given list
+ *
+ * @param list The list to get the length of
+ */
+Unsigned_t ChunkedListLength(ChunkedList_t *list);
+
+/**
+ * @public @memberof ChunkedList_t
+ * Return a pointer to the element at a given index. The list
+ * is walked a chunk at a time, from whichever end is closer
+ *
+ * @param list The list to index
+ * @param idx The index
+ */
+void *ChunkedListIndex(ChunkedList_t *list, Unsigned_t idx);
+
+/**
+ * @public @memberof ChunkedList_t
+ * @brief Create an iterator over the given list
+ *
+ * @param list The list to create the iterator for
+ */
+Iterator_t NewChunkedListIterator(ChunkedList_t *list);
+
+#endif
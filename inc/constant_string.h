@@ -35,4 +35,26 @@ String_t *NewString(char *str);
  */
 Iterator_t NewStringIterator(String_t *s);
 
+/**
+ * @public @memberof String_t
+ * @brief Find the first occurrence of a character
+ * in a string
+ *
+ * @param s The string to search
+ * @param c The character to find
+ * @return A pointer to the first matching character,
+ * or NULL if there is none
+ */
+Character_t *StringFind(String_t *s, Character_t c);
+
+/**
+ * @public @memberof String_t
+ * @brief Count the occurrences of a character in
+ * a string
+ *
+ * @param s The string to search
+ * @param c The character to count
+ */
+Unsigned_t StringCount(String_t *s, Character_t c);
+
 #endif
\ No newline at end of file
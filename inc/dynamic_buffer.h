@@ -0,0 +1,112 @@
+#ifndef __LIB_FUNDEMENTAL_DYNAMIC_BUFFER_H__
+#define __LIB_FUNDEMENTAL_DYNAMIC_BUFFER_H__
+
+/**
+ * @file dynamic_buffer.h
+ * Growable buffer with amortized O(1) append
+ */
+
+#include "fixed_buffer.h"
+
+/**
+ * @private
+ * @def DYNAMIC_BUFFER_MIN_CAPACITY
+ * The number of elements a dynamic buffer has room for
+ * the first time it grows
+ */
+#define DYNAMIC_BUFFER_MIN_CAPACITY 8
+
+/**
+ * @class DynamicBuffer_t
+ * @brief A buffer that grows as elements are pushed onto it
+ *
+ * The elements are kept in an ordinary Buffer_t, whose length
+ * is the number of elements pushed so far. The buffer may be
+ * passed to BufferIndex, NewBufferIterator and the rest of the
+ * Buffer_t functions, but may move whenever the dynamic buffer
+ * grows, so pointers into it should not be kept across pushes
+ */
+typedef struct _dynamic_buffer_s
+{
+    /**
+     * @memberof DynamicBuffer_t
+     * @brief The arena the buffer is allocated against
+     */
+    Arena_t *arena;
+
+    /**
+     * @memberof DynamicBuffer_t
+     * @brief The number of elements there is room for
+     * before the buffer must grow
+     */
+    Unsigned_t capacity;
+
+    /**
+     * @memberof DynamicBuffer_t
+     * @brief The elements of the dynamic buffer
+     */
+    Buffer_t *buffer;
+} DynamicBuffer_t;
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Initialize an empty dynamic buffer
+ *
+ * @param db The dynamic buffer to initialize
+ * @param a The arena to allocate against. The buffer grows
+ * in place while it is the last allocation in the arena. Against
+ * ARENA_NONE the buffer is grown with 'realloc()', and must be
+ * cleaned up with DeconstructDynamicBuffer
+ * @param data_width The width of a single element
+ * @param capacity The number of elements to make room for up front
+ */
+void ConstructDynamicBuffer(DynamicBuffer_t *db, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity);
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Free a dynamic buffer allocated against ARENA_NONE.
+ * Does nothing for other arenas
+ *
+ * @param db The dynamic buffer to cleanup
+ */
+void DeconstructDynamicBuffer(DynamicBuffer_t *db);
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Make sure there is room for at least 'capacity'
+ * elements without growing again
+ *
+ * @param db The dynamic buffer to grow
+ * @param capacity The number of elements to make room for
+ */
+void DynamicBufferReserve(DynamicBuffer_t *db, Unsigned_t capacity);
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Give back any room beyond the elements in the buffer
+ *
+ * @param db The dynamic buffer to shrink
+ */
+void DynamicBufferShrink(DynamicBuffer_t *db);
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Add an element to the end of a dynamic buffer,
+ * and return a pointer to it
+ *
+ * @param db The dynamic buffer to append to
+ * @param data A pointer to the element to copy in. If it is NULL
+ * the new element is zeroed. It may point into the buffer itself
+ */
+void *DynamicBufferPush(DynamicBuffer_t *db, void *data);
+
+/**
+ * @public @memberof DynamicBuffer_t
+ * @brief Remove the element from the end of a dynamic buffer
+ *
+ * @param db The dynamic buffer to remove from. Must not be empty
+ * @param dest The location to copy the element to. May be NULL
+ */
+void DynamicBufferPop(DynamicBuffer_t *db, void *dest);
+
+#endif
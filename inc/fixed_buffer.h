@@ -8,6 +8,7 @@
 
 #include "arena.h"
 #include "iterator.h"
+#include "hash.h"
 
 #include <string.h>
 
@@ -40,6 +41,34 @@ typedef struct _fixed_buffer_s
     Byte_t data[];
 } Buffer_t;
 
+/**
+ * @class BufferSlice_t
+ * @brief A view of a range of elements within a buffer
+ *
+ * Slices do not own their data, and are only valid for
+ * as long as the buffer they were taken from
+ */
+typedef struct _buffer_slice_s
+{
+    /**
+     * @memberof BufferSlice_t
+     * @brief Length, in bytes, of a single data element in the slice
+     */
+    Unsigned_t data_width;
+
+    /**
+     * @memberof BufferSlice_t
+     * @brief Number of data elements in the slice
+     */
+    Unsigned_t length;
+
+    /**
+     * @memberof BufferSlice_t
+     * @brief The first element of the slice
+     */
+    Byte_t *data;
+} BufferSlice_t;
+
 /**
  * @def TOTAL_BUFFER_SIZE
  * Return the total amount of memory used by a given buffer
@@ -67,6 +96,51 @@ Buffer_t *InitializeBuffer(Byte_t *memory, Unsigned_t data_width, Unsigned_t len
  */
 Buffer_t *NewBuffer(Arena_t *a, Unsigned_t data_width, Unsigned_t length);
 
+/**
+ * @public @memberof Buffer_t
+ * Create a new buffer whose data starts on an 'alignment'
+ * byte boundary, so vector loads over the data never split
+ *
+ * @param a The arena to allocate against
+ * @param data_width The width of a single element in the new buffer
+ * @param length The number of elements contained in the buffer
+ * @param alignment The byte boundary to align the data to. Must be a power of two.
+ * Buffers with an alignment larger than their header do not start at the beginning
+ * of their allocation, which is 'alignment' bytes before their data. Only that
+ * address may be passed to 'free()' when allocated against ARENA_NONE, and such
+ * buffers must be resized with ResizeAlignedBuffer
+ */
+Buffer_t *NewAlignedBuffer(Arena_t *a, Unsigned_t data_width, Unsigned_t length, Unsigned_t alignment);
+
+/**
+ * @public @memberof Buffer_t
+ * Change the number of elements in a buffer. The buffer is
+ * resized in place if it was the last thing allocated against
+ * its arena, otherwise it is moved. New elements are zeroed.
+ *
+ * Only buffers that start at the beginning of their allocation
+ * may be resized this way. Buffers made by NewAlignedBuffer
+ * must be resized with ResizeAlignedBuffer instead
+ *
+ * @param a The arena the buffer was allocated against
+ * @param b The buffer to resize
+ * @param length The new number of elements in the buffer
+ */
+Buffer_t *ResizeBuffer(Arena_t *a, Buffer_t *b, Unsigned_t length);
+
+/**
+ * @public @memberof Buffer_t
+ * Change the number of elements in a buffer made by NewAlignedBuffer,
+ * keeping its data aligned. The buffer is resized in place when it
+ * can be, otherwise it is moved. New elements are zeroed
+ *
+ * @param a The arena the buffer was allocated against
+ * @param b The buffer to resize
+ * @param length The new number of elements in the buffer
+ * @param alignment The alignment the buffer was made with
+ */
+Buffer_t *ResizeAlignedBuffer(Arena_t *a, Buffer_t *b, Unsigned_t length, Unsigned_t alignment);
+
 /**
  * @public @memberof Buffer_t
  * Get a pointer to a given element within a buffer
@@ -105,6 +179,94 @@ void BufferCopyElement(Buffer_t *b, void *dest, Unsigned_t src_idx);
  */
 Buffer_t *BufferClone(Buffer_t *b, Arena_t *a);
 
+/**
+ * @public @memberof Buffer_t
+ * Copy a range of elements from one buffer into another.
+ * The ranges must not overlap
+ *
+ * @param dest The buffer to copy into
+ * @param dest_idx The index in 'dest' to copy the first element to
+ * @param src The buffer to copy from. Must have the same data_width as 'dest'
+ * @param src_idx The index of the first element in 'src' to copy
+ * @param count The number of elements to copy
+ */
+void BufferCopyRange(Buffer_t *dest, Unsigned_t dest_idx, Buffer_t *src, Unsigned_t src_idx, Unsigned_t count);
+
+/**
+ * @public @memberof Buffer_t
+ * Write a run of elements to a buffer
+ *
+ * @param b The buffer to write to
+ * @param idx The index to write the first element to
+ * @param data A pointer to the first of 'count' contiguous elements
+ * @param count The number of elements to write
+ */
+void BufferInsertRange(Buffer_t *b, Unsigned_t idx, void *data, Unsigned_t count);
+
+/**
+ * @public @memberof Buffer_t
+ * Move a range of elements within a buffer. The source
+ * and destination ranges may overlap
+ *
+ * @param b The buffer to modify
+ * @param dest_idx The index to move the first element to
+ * @param src_idx The index of the first element to move
+ * @param count The number of elements to move
+ */
+void BufferMoveRange(Buffer_t *b, Unsigned_t dest_idx, Unsigned_t src_idx, Unsigned_t count);
+
+/**
+ * @public @memberof Buffer_t
+ * Set a range of elements in a buffer to the same value
+ *
+ * @param b The buffer to modify
+ * @param idx The index of the first element to set
+ * @param count The number of elements to set
+ * @param data A pointer to the value to set them to. If it
+ * is NULL, the elements are zeroed
+ */
+void BufferFill(Buffer_t *b, Unsigned_t idx, Unsigned_t count, void *data);
+
+/**
+ * @public @memberof Buffer_t
+ * Compare the contents of two buffers byte by byte, like
+ * 'memcmp()'. If one buffer is a prefix of the other, the
+ * shorter buffer is less
+ *
+ * @param a The first buffer to compare
+ * @param b The second buffer to compare. Must have the same data_width as 'a'
+ */
+int BufferCompare(Buffer_t *a, Buffer_t *b);
+
+/**
+ * @public @memberof Buffer_t
+ * Create a view of a range of elements in a buffer,
+ * without copying them
+ *
+ * @param b The buffer to take the slice from
+ * @param idx The index of the first element in the slice
+ * @param count The number of elements in the slice
+ */
+BufferSlice_t BufferSlice(Buffer_t *b, Unsigned_t idx, Unsigned_t count);
+
+/**
+ * @public @memberof BufferSlice_t
+ * Get a pointer to a given element within a slice
+ *
+ * @param s The slice to index
+ * @param idx The offset (from the start of the slice) to get the element from
+ */
+void *BufferSliceIndex(BufferSlice_t *s, Unsigned_t idx);
+
+/**
+ * @public @memberof BufferSlice_t
+ * Copy the elements of a slice into a new buffer
+ *
+ * @param s The slice to copy
+ * @param a The arena to allocate the new buffer against
+ */
+Buffer_t *BufferSliceClone(BufferSlice_t *s, Arena_t *a);
+
 /**
  * @public @memberof Buffer_t
  * Hash the contents of a given buffer
@@ -115,7 +277,8 @@ Unsigned_t BufferHash(Buffer_t *b);
 
 /**
  * Hash contents of a raw buffer using the algorithm
- * used by BufferHash
+ * used by BufferHash. See hash.h for seeded and
+ * streaming variants
  *
  * @param buff The raw buffer to hash
  * @param length The length of the raw buffer
@@ -0,0 +1,96 @@
+#ifndef __LIB_FUNDEMENTAL_HASH_H__
+#define __LIB_FUNDEMENTAL_HASH_H__
+
+/**
+ * @file hash.h
+ * Fast, seedable 64-bit hashing of raw memory. Inputs are
+ * consumed a word at a time, with long inputs run through
+ * four independent lanes, using AVX2 when the CPU has it
+ */
+
+#include "basic_types.h"
+
+/**
+ * @def HASH_DEFAULT_SEED
+ * The seed used by RawBufferHash and BufferHash
+ */
+#define HASH_DEFAULT_SEED 0
+
+/**
+ * @private
+ * @def HASH_STRIPE_SIZE
+ * The number of bytes consumed by each step of the
+ * hash's four lanes
+ */
+#define HASH_STRIPE_SIZE 32
+
+/**
+ * @private
+ * @def HASH_STRIPES_PER_BLOCK
+ * The number of stripes consumed between each scramble
+ * of the hash's lanes
+ */
+#define HASH_STRIPES_PER_BLOCK 16
+
+/**
+ * @class HashState_t
+ * @brief The state of a hash being computed over data
+ * that arrives a piece at a time
+ *
+ * Hashing data in pieces gives the same result as
+ * hashing it all at once with RawBufferHashSeeded
+ */
+typedef struct _hash_state_s
+{
+    /** The four lanes that stripes are accumulated into */
+    Unsigned_t lanes[HASH_STRIPE_SIZE / sizeof(Unsigned_t)];
+
+    /** The seed the hash was started with */
+    Unsigned_t seed;
+
+    /** The total number of bytes hashed so far */
+    Unsigned_t length;
+
+    /** Bytes that have not yet made up a full stripe */
+    Byte_t pending[HASH_STRIPE_SIZE];
+} HashState_t;
+
+/**
+ * Hash the contents of a raw buffer with a given seed.
+ * Different seeds give unrelated hashes for the same data
+ *
+ * @param buff The raw buffer to hash
+ * @param length The length of the raw buffer
+ * @param seed The seed for the hash
+ */
+Unsigned_t RawBufferHashSeeded(Byte_t *buff, Unsigned_t length, Unsigned_t seed);
+
+/**
+ * @public @memberof HashState_t
+ * @brief Start a new hash
+ *
+ * @param state The hash state to initialize
+ * @param seed The seed for the hash
+ */
+void HashStateInit(HashState_t *state, Unsigned_t seed);
+
+/**
+ * @public @memberof HashState_t
+ * @brief Add data to a hash
+ *
+ * @param state The hash to add to
+ * @param data The data to add
+ * @param length The length of the data
+ */
+void HashStateUpdate(HashState_t *state, Byte_t *data, Unsigned_t length);
+
+/**
+ * @public @memberof HashState_t
+ * @brief Get the hash of all the data added so far. The
+ * state is left unchanged, so more data may still be added
+ *
+ * @param state The hash to finish
+ */
+Unsigned_t HashStateFinal(HashState_t *state);
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef __LIB_FUNDEMENTAL_INTRUSIVE_LIST_H__
+#define __LIB_FUNDEMENTAL_INTRUSIVE_LIST_H__
+
+/**
+ * @file intrusive_list.h
+ * A circular, doubly-linked list of caller-owned objects.
+ * Objects embed a ListLink_t, and are linked through it,
+ * so no list operation ever allocates or copies data
+ */
+
+#include <stddef.h>
+
+#include "basic_types.h"
+#include "iterator.h"
+
+/**
+ * @class ListLink_t
+ * @brief A link embedded in an object, so it can be put on a list
+ *
+ * An object may embed several links, to sit on several lists at
+ * once. A link that is not on a list points to itself
+ */
+typedef struct _list_link_s
+{
+    /**
+     * @memberof ListLink_t
+     * @brief The next link in the list
+     */
+    struct _list_link_s *next;
+
+    /**
+     * @memberof ListLink_t
+     * @brief The previous link in the list
+     */
+    struct _list_link_s *previous;
+} ListLink_t;
+
+/**
+ * @class IntrusiveList_t
+ * @brief A list of embedded links
+ *
+ * The list's own link is a sentinel between the last and first
+ * links, so inserting and removing never has to check whether
+ * the list is empty. Since the sentinel points into the list
+ * itself, an IntrusiveList_t must not be copied or moved once
+ * it is constructed
+ */
+typedef struct _intrusive_list_s
+{
+    /** Sits between the last and first links */
+    ListLink_t sentinel;
+} IntrusiveList_t;
+
+/**
+ * @def LIST_CONTAINER
+ * Get a pointer to the object a link is embedded in
+ *
+ * @param LINK A pointer to the link
+ * @param TYPE The type of the object
+ * @param MEMBER The name of the link within the object
+ */
+#define LIST_CONTAINER(LINK, TYPE, MEMBER) ((TYPE *)((Byte_t *)(LINK) - offsetof(TYPE, MEMBER)))
+
+/**
+ * @public @memberof ListLink_t
+ * Initialize a link that is not on any list
+ *
+ * @param link The link to initialize
+ */
+void InitializeListLink(ListLink_t *link);
+
+/**
+ * @public @memberof ListLink_t
+ * Check if a link is on a list
+ *
+ * @param link The link to check. Must have been initialized, or
+ * inserted into a list
+ */
+Boolean_t ListLinkIsLinked(ListLink_t *link);
+
+/**
+ * @public @memberof ListLink_t
+ * Take a link off whichever list it is on. The link
+ * is left initialized, and may be inserted again
+ *
+ * @param link The link to remove
+ */
+void ListLinkRemove(ListLink_t *link);
+
+/**
+ * @public @memberof ListLink_t
+ * Insert a link into a list, directly after another
+ *
+ * @param position A link already on a list, or the sentinel of a list
+ * @param link The link to insert. Must not be on a list
+ */
+void ListLinkInsertAfter(ListLink_t *position, ListLink_t *link);
+
+/**
+ * @public @memberof ListLink_t
+ * Insert a link into a list, directly before another
+ *
+ * @param position A link already on a list, or the sentinel of a list
+ * @param link The link to insert. Must not be on a list
+ */
+void ListLinkInsertBefore(ListLink_t *position, ListLink_t *link);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Initialize an empty list
+ *
+ * @param list The list to initialize
+ */
+void ConstructIntrusiveList(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Check if a list has no links
+ *
+ * @param list The list to check
+ */
+Boolean_t IntrusiveListIsEmpty(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Add a link to the end of a list
+ *
+ * @param list The list to modify
+ * @param link The link to add. Must not be on a list
+ */
+void IntrusiveListInsertBack(IntrusiveList_t *list, ListLink_t *link);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Add a link to the front of a list
+ *
+ * @param list The list to modify
+ * @param link The link to add. Must not be on a list
+ */
+void IntrusiveListInsertFront(IntrusiveList_t *list, ListLink_t *link);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Remove the link at the end of a list
+ *
+ * @param list The list to modify
+ * @return The removed link, or NULL if the list was empty
+ */
+ListLink_t *IntrusiveListRemoveBack(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Remove the link at the front of a list
+ *
+ * @param list The list to modify
+ * @return The removed link, or NULL if the list was empty
+ */
+ListLink_t *IntrusiveListRemoveFront(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Get the first link of a list
+ *
+ * @param list The list to look at
+ * @return The first link, or NULL if the list is empty
+ */
+ListLink_t *IntrusiveListFirst(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Get the last link of a list
+ *
+ * @param list The list to look at
+ * @return The last link, or NULL if the list is empty
+ */
+ListLink_t *IntrusiveListLast(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Get the link after a given one
+ *
+ * @param list The list the link is on
+ * @param link The link to step from
+ * @return The next link, or NULL if 'link' is the last
+ */
+ListLink_t *IntrusiveListNext(IntrusiveList_t *list, ListLink_t *link);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Get the number of links in a list. This walks the list
+ *
+ * @param list The list to get the length of
+ */
+Unsigned_t IntrusiveListLength(IntrusiveList_t *list);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * Move every link of one list onto the end of another.
+ * This takes the same time no matter how long the lists are
+ *
+ * @param dest The list to add the links to
+ * @param src The list to take the links from. It is left empty
+ */
+void IntrusiveListSplice(IntrusiveList_t *dest, IntrusiveList_t *src);
+
+/**
+ * @public @memberof IntrusiveList_t
+ * @brief Create an iterator over the given list. The
+ * items of the iterator are the links, which can be
+ * turned back into objects with LIST_CONTAINER
+ *
+ * @param list The list to create the iterator for
+ */
+Iterator_t NewIntrusiveListIterator(IntrusiveList_t *list);
+
+#endif
@@ -9,6 +9,7 @@
  */
 
 #include "arena.h"
+#include "pool.h"
 #include "iterator.h"
 
 /**
@@ -45,12 +46,33 @@ typedef struct _list_node_s
 /**
  * @class List_t
  * @brief A linked list
+ *
+ * The number of nodes is kept up to date by every list
+ * operation, so the length of a list is known without
+ * walking it. Lists should only be changed through the
+ * List functions, so the count stays correct
  */
 typedef struct _list_s
 {
+    /**
+     * @memberof List_t
+     * @brief The first node of the list, or NULL if it is empty
+     */
     ListNode_t *first_element;
+
+    /**
+     * @memberof List_t
+     * @brief The number of nodes in the list
+     */
+    Unsigned_t length;
 } List_t;
 
+/**
+ * @def LIST_NODE_SIZE
+ * The total size of a list node with a data section of length 'LENGTH'
+ */
+#define LIST_NODE_SIZE(LENGTH) (sizeof(ListNode_t) + (LENGTH))
+
 /**
  * @def LIST_LOOP
  * A macro to make writing 'for' loops over linked lists easier
@@ -76,6 +98,21 @@ typedef struct _list_s
  */
 ListNode_t *NewListNode(Arena_t *arena, void *data, Unsigned_t length);
 
+/**
+ * @public @memberof ListNode_t
+ *
+ * Create a list node in a slot taken from a pool. Behaves like
+ * NewListNode, but the node can be given back to the pool with
+ * PoolFree once it has been removed from its list
+ *
+ * @param pool The pool to take the node from. Its slots must be
+ * at least LIST_NODE_SIZE(length) bytes
+ * @param data The data to copy into the list node. If it is NULL, the
+ * node's data section will be left uninitialized
+ * @param length The length of the data section
+ */
+ListNode_t *NewPooledListNode(Pool_t *pool, void *data, Unsigned_t length);
+
 /**
  * @public @memberof ListNode_t
  *
@@ -88,7 +125,8 @@ void ListNodeWriteData(ListNode_t *ln, void *data);
 
 /**
  * @public @memberof List_t
- * Add a list element to the end of a list
+ * Add a list element to the end of a list. If 'new_node' is linked
+ * to other nodes, the whole circle of nodes is added, in order
  *
  * @param list The list to modify
  * @param new_node The list node to add to the list
@@ -105,7 +143,8 @@ ListNode_t *ListRemoveBack(List_t *list);
 
 /**
  * @public @memberof List_t
- * Add a list element to the front of a list
+ * Add a list element to the front of a list. If 'new_node' is linked
+ * to other nodes, the whole circle of nodes is added, in order
  *
  * @param list The list to modify
  * @param new_node The list node to add to the list
@@ -122,7 +161,67 @@ ListNode_t *ListRemoveFront(List_t *list);
 
 /**
  * @public @memberof List_t
- * Get the number of elements in a given list
+ * Take a node out of a list, wherever it is. Only the
+ * neighbouring nodes are relinked
+ *
+ * @param list The list the node is on
+ * @param node The node to remove. It is returned linked only to itself
+ */
+ListNode_t *ListRemoveNode(List_t *list, ListNode_t *node);
+
+/**
+ * @public @memberof List_t
+ * Move every node of one list onto the end of another
+ *
+ * @param dest The list to add the nodes to
+ * @param src The list to take the nodes from. It is left empty
+ */
+void ListConcat(List_t *dest, List_t *src);
+
+/**
+ * @public @memberof List_t
+ * Move every node of one list into another, directly after a
+ * given node
+ *
+ * @param list The list to add the nodes to
+ * @param position The node in 'list' to insert after. If it is NULL,
+ * the nodes are inserted at the front of the list
+ * @param src The list to take the nodes from. It is left empty
+ */
+void ListSplice(List_t *list, ListNode_t *position, List_t *src);
+
+/**
+ * @public @memberof List_t
+ * Split a list in two. A node, and every node after it up to the
+ * end of the list, are moved into another list
+ *
+ * Counting the nodes moved walks from both ends of the list at
+ * once, so it takes time in proportion to the smaller half
+ *
+ * @param list The list to split
+ * @param node The first node to move. If it is the first node of
+ * 'list', the whole list is moved
+ * @param dest The list to move the nodes to. Must be empty
+ */
+void ListSplit(List_t *list, ListNode_t *node, List_t *dest);
+
+/**
+ * @public @memberof List_t
+ * Sort the nodes of a list, keeping nodes that compare equal in
+ * the order they started in. This is a bottom-up merge sort that
+ * only relinks nodes, so it never allocates, and runs in
+ * O(n log n) time
+ *
+ * @param list The list to sort
+ * @param compare The function used to order the nodes. It is
+ * passed pointers to the data sections of two nodes
+ */
+void ListSort(List_t *list, Comparator_t compare);
+
+/**
+ * @public @memberof List_t
+ * Get the number of elements in a given list. The count
+ * is kept in the list, so this does not walk it
  *
  * @param list The list to get the length of
  */
@@ -130,7 +229,8 @@ Unsigned_t ListLength(List_t *list);
 
 /**
  * @public @memberof List_t
- * Return the ListNode_t at a given index
+ * Return the ListNode_t at a given index. The list is
+ * walked from whichever end is nearer
  *
  * @param list The list to index
  * @param idx The index
@@ -0,0 +1,100 @@
+#ifndef __LIB_FUNDEMENTAL_MPSC_QUEUE_H__
+#define __LIB_FUNDEMENTAL_MPSC_QUEUE_H__
+
+/**
+ * @file mpsc_queue.h
+ * Lock-free queue of list nodes, for handing work from
+ * many threads to one
+ */
+
+#include "linked_list.h"
+#include "alignment.h"
+
+/**
+ * @class MpscQueue_t
+ * @brief An unbounded multi-producer, single-consumer queue of ListNode_t
+ *
+ * Nodes are linked through their 'next' field, so pushing never
+ * allocates. Pushing is wait-free: a single atomic exchange on the
+ * back of the queue, then a store linking the old back to the new
+ * node. Only one thread may pop at a time. A stub node stays in the
+ * queue, so the queue is never completely unlinked.
+ *
+ * Because the stub points into the queue itself, an MpscQueue_t must
+ * not be copied or moved once it is constructed. Queues allocated
+ * against an arena should be allocated with ArenaAllocateAligned,
+ * aligned to CACHE_LINE_SIZE
+ */
+/**
+ * @private
+ * A list node without a data section. It shares the layout of
+ * ListNode_t up to its data, so the queue can hold one directly
+ */
+typedef struct _mpsc_stub_s
+{
+    ListNode_t *next;
+    ListNode_t *previous;
+    Unsigned_t length;
+} MpscStub_t;
+
+typedef struct _mpsc_queue_s
+{
+    /** The node most recently pushed. Exchanged by every producer */
+    ListNode_t *back ATTRIBUTE_CACHE_ALIGNED;
+
+    /** The next node to pop. Only touched by the consumer */
+    ListNode_t *front ATTRIBUTE_CACHE_ALIGNED;
+
+    /**
+     * A node with no data, kept in the queue so it always has a node.
+     * ListNode_t ends in a flexible array member, so it cannot be
+     * embedded in another structure directly. The queue only reads
+     * and writes the stub through this member
+     */
+    MpscStub_t stub;
+} MpscQueue_t;
+
+/**
+ * @public @memberof MpscQueue_t
+ * Initialize an empty queue
+ *
+ * @param q The queue to initialize
+ */
+void ConstructMpscQueue(MpscQueue_t *q);
+
+/**
+ * @public @memberof MpscQueue_t
+ * Push a node onto the back of a queue. May be called from
+ * any number of threads at once
+ *
+ * @param q The queue to push onto
+ * @param node The node to push. Must not be on a list or queue
+ */
+void MpscQueuePush(MpscQueue_t *q, ListNode_t *node);
+
+/**
+ * @public @memberof MpscQueue_t
+ * Pop the node at the front of a queue. Must only be called
+ * from the consumer thread
+ *
+ * @param q The queue to pop from
+ * @return The popped node, unlinked as if it had just been made by
+ * NewListNode, or NULL if the queue is empty. NULL is also returned
+ * while the only node is still part way through being pushed
+ */
+ListNode_t *MpscQueuePop(MpscQueue_t *q);
+
+/**
+ * @public @memberof MpscQueue_t
+ * Pop nodes off the front of a queue, and add them to the end of
+ * a list, in the order they were popped. Must only be called from
+ * the consumer thread
+ *
+ * @param q The queue to pop from
+ * @param dest The list to add the nodes to
+ * @param max The most nodes to pop
+ * @return The number of nodes popped
+ */
+Unsigned_t MpscQueueDrain(MpscQueue_t *q, List_t *dest, Unsigned_t max);
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef __LIB_FUNDEMENTAL_PARALLEL_H__
+#define __LIB_FUNDEMENTAL_PARALLEL_H__
+
+/**
+ * @file parallel.h
+ * Multithreaded sorting and reductions over buffers. The
+ * buffer is split into one contiguous chunk per thread, and
+ * the calling thread works on the first chunk itself. Every
+ * call returns only once all of its threads have finished
+ */
+
+#include "fixed_buffer.h"
+
+/**
+ * @private
+ * @def PARALLEL_MAX_THREADS
+ * The most threads a single parallel operation will use
+ */
+#define PARALLEL_MAX_THREADS 64
+
+/**
+ * @private
+ * @def PARALLEL_MIN_CHUNK
+ * The fewest elements worth handing to a thread. Buffers
+ * smaller than this are worked on by the calling thread alone
+ */
+#define PARALLEL_MIN_CHUNK (1 << 14)
+
+/**
+ * @private
+ * @def PARALLEL_OVERSAMPLE
+ * The number of samples taken per thread when choosing the
+ * splitters of a parallel sort. More samples split the buffer
+ * more evenly between threads
+ */
+#define PARALLEL_OVERSAMPLE 32
+
+/**
+ * Set the number of threads parallel operations may use
+ *
+ * @param threads The number of threads. If 0, which is the
+ * default, one thread is used for every online processor
+ */
+void SetParallelThreadCount(Unsigned_t threads);
+
+/**
+ * @public @memberof Buffer_t
+ * Sort the elements of a buffer across several threads, with
+ * a sample sort. The sort is not stable
+ *
+ * @param b The buffer to sort
+ * @param compare The function used to order the elements. It
+ * is called from several threads at once
+ * @param scratch The arena to take scratch space from. It is
+ * rewound before returning, so must not be a concurrent arena
+ */
+void BufferParallelSort(Buffer_t *b, Comparator_t compare, Arena_t *scratch);
+
+/**
+ * @public @memberof Buffer_t
+ * Add up the elements of a buffer across several threads. The
+ * sum wraps around on overflow
+ *
+ * @param b The buffer to sum. Its data_width must be 1, 2, 4 or 8,
+ * and its elements are read as unsigned integers of that width
+ */
+Unsigned_t BufferParallelSum(Buffer_t *b);
+
+/**
+ * @public @memberof Buffer_t
+ * Find the smallest element of a buffer across several threads
+ *
+ * @param b The buffer to search
+ * @param compare The function used to order the elements
+ * @return A pointer to the first of the smallest elements, or
+ * NULL if the buffer is empty
+ */
+void *BufferParallelMin(Buffer_t *b, Comparator_t compare);
+
+/**
+ * @public @memberof Buffer_t
+ * Find the largest element of a buffer across several threads
+ *
+ * @param b The buffer to search
+ * @param compare The function used to order the elements
+ * @return A pointer to the first of the largest elements, or
+ * NULL if the buffer is empty
+ */
+void *BufferParallelMax(Buffer_t *b, Comparator_t compare);
+
+/**
+ * @public @memberof Buffer_t
+ * Count the elements of a buffer that pass a test, across
+ * several threads
+ *
+ * @param b The buffer to count elements in
+ * @param predicate The test to apply to each element. It is
+ * called from several threads at once
+ * @param context Passed to every call of 'predicate'
+ */
+Unsigned_t BufferParallelCountIf(Buffer_t *b, Predicate_t predicate, void *context);
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef __LIB_FUNDEMENTAL_POOL_H__
+#define __LIB_FUNDEMENTAL_POOL_H__
+
+/**
+ * @file pool.h
+ * Fixed-size slot allocator layered on an arena. Slots
+ * that are freed are reused by later allocations, so
+ * memory stays bounded when objects are constantly
+ * created and thrown away
+ */
+
+#include "arena.h"
+
+/**
+ * @private
+ * @def POOL_SLAB_SIZE
+ * The number of bytes of slots a pool takes from its
+ * arena at once, when it runs out of free slots
+ */
+#define POOL_SLAB_SIZE ARENA_BLOCK_SIZE
+
+/**
+ * @private
+ * A free slot, linked into the pool's free list
+ */
+typedef struct _pool_slot_s
+{
+    struct _pool_slot_s *next;
+} PoolSlot_t;
+
+/**
+ * @class Pool_t
+ * @brief A pool of fixed-size memory slots
+ *
+ * Slots are carved out of slabs allocated against an arena.
+ * Slots given back to the pool are kept on a free list, and
+ * handed out again before a new slab is allocated. The memory
+ * of the pool is only free'd when its arena is deconstructed.
+ *
+ * The pool keeps pointers into its slabs. If the arena is rewound
+ * or reset, those slabs are handed out by the arena again, so the
+ * pool must be reset with PoolReset before it is used again
+ */
+typedef struct _pool_s
+{
+    /**
+     * @memberof Pool_t
+     * @brief The arena slabs are allocated against
+     */
+    Arena_t *arena;
+
+    /**
+     * @memberof Pool_t
+     * @brief The size, in bytes, of a single slot
+     */
+    Unsigned_t slot_size;
+
+    /**
+     * @memberof Pool_t
+     * @brief The byte boundary every slot starts on
+     */
+    Unsigned_t alignment;
+
+    /**
+     * @memberof Pool_t
+     * @brief Slots that have been given back to the pool
+     */
+    PoolSlot_t *free_slots;
+
+    /**
+     * @memberof Pool_t
+     * @brief The next slot in the current slab that has never been handed out
+     */
+    Byte_t *slab_next;
+
+    /**
+     * @memberof Pool_t
+     * @brief The end of the current slab
+     */
+    Byte_t *slab_end;
+} Pool_t;
+
+/**
+ * @public @memberof Pool_t
+ * @brief Initialize a pool of slots
+ *
+ * @param pool The pool to initialize
+ * @param arena The arena to allocate slabs against. Must not
+ * be ARENA_NONE, since the slabs would never be free'd. Rewinding
+ * or resetting the arena frees every slot, and the pool must then
+ * be reset with PoolReset
+ * @param slot_size The size, in bytes, of every slot in the pool
+ */
+void ConstructPool(Pool_t *pool, Arena_t *arena, Unsigned_t slot_size);
+
+/**
+ * @public @memberof Pool_t
+ * @brief Initialize a pool whose slots all start on an
+ * 'alignment' byte boundary, such as CACHE_LINE_SIZE
+ *
+ * @param pool The pool to initialize
+ * @param arena The arena to allocate slabs against. The same
+ * rules apply as for ConstructPool
+ * @param slot_size The size, in bytes, of every slot in the pool.
+ * It is rounded up to a multiple of 'alignment'
+ * @param alignment The byte boundary to align slots to. Must be a power of two
+ */
+void ConstructAlignedPool(Pool_t *pool, Arena_t *arena, Unsigned_t slot_size, Unsigned_t alignment);
+
+/**
+ * @public @memberof Pool_t
+ * @brief Forget every slot of a pool, as if it had just been
+ * constructed. Must be called after the pool's arena is rewound
+ * past, or reset over, the pool's slabs. Slots taken from the
+ * pool before it was reset must not be used or given back
+ *
+ * @param pool The pool to reset
+ */
+void PoolReset(Pool_t *pool);
+
+/**
+ * @public @memberof Pool_t
+ * @brief Take a slot from a pool. The slot's contents
+ * are left uninitialized
+ *
+ * @param pool The pool to allocate from
+ */
+void *PoolAllocate(Pool_t *pool);
+
+/**
+ * @public @memberof Pool_t
+ * @brief Give a slot back to the pool it was taken from
+ *
+ * @param pool The pool the slot was allocated from
+ * @param slot The slot to give back
+ */
+void PoolFree(Pool_t *pool, void *slot);
+
+#endif
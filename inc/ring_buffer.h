@@ -0,0 +1,139 @@
+#ifndef __LIB_FUNDEMENTAL_RING_BUFFER_H__
+#define __LIB_FUNDEMENTAL_RING_BUFFER_H__
+
+/**
+ * @file ring_buffer.h
+ * Lock-free queue for handing elements from one
+ * thread to another
+ */
+
+#include "fixed_buffer.h"
+#include "alignment.h"
+
+/**
+ * @class RingBuffer_t
+ * @brief A bounded single-producer, single-consumer queue
+ *
+ * Elements are copied into a Buffer_t whose length is a power of
+ * two. Exactly one thread may push, and exactly one thread may pop,
+ * at a time, without any locking. The consumer's and producer's
+ * indices sit on separate cache lines, and each side keeps a copy of
+ * the other's index, so the two threads only touch each other's
+ * cache line when the queue looks full or empty.
+ *
+ * Ring buffers allocated against an arena should be allocated with
+ * ArenaAllocateAligned, aligned to CACHE_LINE_SIZE
+ */
+typedef struct _ring_buffer_s
+{
+    /**
+     * @memberof RingBuffer_t
+     * @brief The arena the storage is allocated against
+     */
+    Arena_t *arena;
+
+    /**
+     * @memberof RingBuffer_t
+     * @brief Storage for the elements. Its length is the
+     * capacity of the ring buffer
+     */
+    Buffer_t *buffer;
+
+    /** Length of the buffer minus one, to turn indices into positions */
+    Unsigned_t mask;
+
+    /** The number of elements popped. Written only by the consumer */
+    Unsigned_t head ATTRIBUTE_CACHE_ALIGNED;
+
+    /** The consumer's last look at 'tail' */
+    Unsigned_t cached_tail;
+
+    /** The number of elements pushed. Written only by the producer */
+    Unsigned_t tail ATTRIBUTE_CACHE_ALIGNED;
+
+    /** The producer's last look at 'head' */
+    Unsigned_t cached_head;
+} RingBuffer_t;
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Initialize an empty ring buffer
+ *
+ * @param rb The ring buffer to initialize
+ * @param a The arena to allocate storage against. Against
+ * ARENA_NONE the ring buffer must be cleaned up with
+ * DeconstructRingBuffer
+ * @param data_width The width of a single element
+ * @param capacity The number of elements the ring buffer can
+ * hold. It is rounded up to a power of two
+ */
+void ConstructRingBuffer(RingBuffer_t *rb, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Free the storage of a ring buffer allocated
+ * against ARENA_NONE. Does nothing for other arenas
+ *
+ * @param rb The ring buffer to deconstruct
+ */
+void DeconstructRingBuffer(RingBuffer_t *rb);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Copy an element onto the back of a ring buffer.
+ * Must only be called from the producer thread
+ *
+ * @param rb The ring buffer to push onto
+ * @param data The element to copy in
+ * @return false if the ring buffer was full
+ */
+Boolean_t RingBufferPush(RingBuffer_t *rb, void *data);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Copy an element off the front of a ring buffer.
+ * Must only be called from the consumer thread
+ *
+ * @param rb The ring buffer to pop from
+ * @param dest Where to copy the element to
+ * @return false if the ring buffer was empty
+ */
+Boolean_t RingBufferPop(RingBuffer_t *rb, void *dest);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Copy as many elements as there is room for onto
+ * the back of a ring buffer. Must only be called from the
+ * producer thread
+ *
+ * @param rb The ring buffer to push onto
+ * @param data A pointer to the first of 'count' contiguous elements
+ * @param count The number of elements to push
+ * @return The number of elements pushed
+ */
+Unsigned_t RingBufferPushBatch(RingBuffer_t *rb, void *data, Unsigned_t count);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief Copy up to 'count' elements off the front of a ring
+ * buffer. Must only be called from the consumer thread
+ *
+ * @param rb The ring buffer to pop from
+ * @param dest Where to copy the elements to. Must have room
+ * for 'count' elements
+ * @param count The most elements to pop
+ * @return The number of elements popped
+ */
+Unsigned_t RingBufferPopBatch(RingBuffer_t *rb, void *dest, Unsigned_t count);
+
+/**
+ * @public @memberof RingBuffer_t
+ * @brief The number of elements in a ring buffer. If the
+ * other thread is pushing or popping, this may already be
+ * out of date when it returns
+ *
+ * @param rb The ring buffer to count the elements of
+ */
+Unsigned_t RingBufferCount(RingBuffer_t *rb);
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef __LIB_FUNDEMENTAL_TYPED_BUFFER_H__
+#define __LIB_FUNDEMENTAL_TYPED_BUFFER_H__
+
+/**
+ * @file typed_buffer.h
+ * Buffers with an element type known at compile time.
+ * The accessors index with a constant element size, so
+ * loops over them compile to plain loads and stores, and
+ * can be vectorized
+ */
+
+#include "fixed_buffer.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * @def DEFINE_TYPED_BUFFER
+ * Define a buffer type 'NAME_t' holding elements of type
+ * 'TYPE', along with its accessors:
+ *
+ * - 'NAME_t *NewNAME(Arena_t *a, Unsigned_t length)'
+ * - 'NAME_t *NAMEFromBuffer(Buffer_t *b)'
+ * - 'Buffer_t *NAMEAsBuffer(NAME_t *b)'
+ * - 'TYPE *NAMEIndex(NAME_t *b, Unsigned_t idx)'
+ * - 'TYPE NAMEGet(NAME_t *b, Unsigned_t idx)'
+ * - 'void NAMESet(NAME_t *b, Unsigned_t idx, TYPE value)'
+ *
+ * 'NAME_t' shares the layout of Buffer_t, so typed buffers
+ * can be passed to any of the Buffer_t functions through
+ * 'NAMEAsBuffer', and plain buffers of the right width can
+ * be viewed as typed buffers through 'NAMEFromBuffer'
+ *
+ * @param NAME The name of the buffer type
+ * @param TYPE The type of the elements in the buffer. Its
+ * alignment must not push the data past where it sits in Buffer_t
+ */
+#define DEFINE_TYPED_BUFFER(NAME, TYPE)                                                  \
+    typedef struct _##NAME##_s                                                           \
+    {                                                                                    \
+        Unsigned_t data_width;                                                           \
+        Unsigned_t length;                                                               \
+        TYPE data[];                                                                     \
+    } NAME##_t;                                                                          \
+                                                                                         \
+    _Static_assert(offsetof(NAME##_t, data_width) == offsetof(Buffer_t, data_width) &&   \
+                       offsetof(NAME##_t, length) == offsetof(Buffer_t, length) &&       \
+                       offsetof(NAME##_t, data) == offsetof(Buffer_t, data),             \
+                   #NAME " does not share the layout of Buffer_t");                      \
+                                                                                         \
+    static inline NAME##_t *New##NAME(Arena_t *a, Unsigned_t length)                     \
+    {                                                                                    \
+        return (NAME##_t *)NewBuffer(a, sizeof(TYPE), length);                           \
+    }                                                                                    \
+                                                                                         \
+    static inline NAME##_t *NAME##FromBuffer(Buffer_t *b)                                \
+    {                                                                                    \
+        assert(b->data_width == sizeof(TYPE));                                           \
+        return (NAME##_t *)b;                                                            \
+    }                                                                                    \
+                                                                                         \
+    static inline Buffer_t *NAME##AsBuffer(NAME##_t *b)                                  \
+    {                                                                                    \
+        return (Buffer_t *)b;                                                            \
+    }                                                                                    \
+                                                                                         \
+    static inline TYPE *NAME##Index(NAME##_t *b, Unsigned_t idx)                         \
+    {                                                                                    \
+        assert(idx < b->length);                                                         \
+        return &b->data[idx];                                                            \
+    }                                                                                    \
+                                                                                         \
+    static inline TYPE NAME##Get(NAME##_t *b, Unsigned_t idx)                            \
+    {                                                                                    \
+        assert(idx < b->length);                                                         \
+        return b->data[idx];                                                             \
+    }                                                                                    \
+                                                                                         \
+    static inline void NAME##Set(NAME##_t *b, Unsigned_t idx, TYPE value)                \
+    {                                                                                    \
+        assert(idx < b->length);                                                         \
+        b->data[idx] = value;                                                            \
+    }
+
+#endif
@@ -1,73 +1,733 @@
 #include <malloc.h>
+#include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "arena.h"
 #include "alignment.h"
 
-void init_block(ArenaBlock_t **block, Unsigned_t size)
+#ifdef ARENA_STATS
+static ArenaStats_t global_stats;
+
+void global_stats_reserve(Unsigned_t size)
+{
+    Unsigned_t reserved = __atomic_add_fetch(&global_stats.bytes_reserved, size, __ATOMIC_RELAXED);
+    Unsigned_t peak = __atomic_load_n(&global_stats.high_water, __ATOMIC_RELAXED);
+    while (reserved > peak &&
+           !__atomic_compare_exchange_n(&global_stats.high_water, &peak, reserved, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+#define GLOBAL_STATS_ALLOCATE(SIZE)                                                \
+    {                                                                              \
+        __atomic_add_fetch(&global_stats.allocations, 1, __ATOMIC_RELAXED);        \
+        __atomic_add_fetch(&global_stats.bytes_requested, SIZE, __ATOMIC_RELAXED); \
+    }
+#define GLOBAL_STATS_RESERVE(SIZE) global_stats_reserve(SIZE)
+#define GLOBAL_STATS_RELEASE(SIZE) __atomic_sub_fetch(&global_stats.bytes_reserved, SIZE, __ATOMIC_RELAXED)
+#else
+#define GLOBAL_STATS_ALLOCATE(SIZE)
+#define GLOBAL_STATS_RESERVE(SIZE)
+#define GLOBAL_STATS_RELEASE(SIZE)
+#endif
+
+/* The first usable byte of a block */
+Byte_t *block_data(ArenaBlock_t *b)
+{
+    return (Byte_t *)(b + 1);
+}
+
+/* A shard of the process-wide cache of free blocks. Holds one
+ * list of blocks for each standard block size */
+typedef struct _block_cache_shard_s
 {
-    Byte_t *mem = malloc(size + sizeof(ArenaBlock_t));
+    Boolean_t locked;
+    Unsigned_t cached;
+    ArenaBlock_t *blocks[ARENA_CACHE_CLASSES];
+} ATTRIBUTE_CACHE_ALIGNED BlockCacheShard_t;
+
+static BlockCacheShard_t block_cache[ARENA_CACHE_SHARDS];
+static __thread Unsigned_t thread_shard = 0;
+static Unsigned_t last_shard = 0;
 
-    for (int i = 0; i < size + sizeof(ArenaBlock_t); i++)
+/* The cache list a block of 'size' usable bytes belongs in, or -1
+ * if blocks of that size aren't cached */
+Signed_t block_class(Unsigned_t size)
+{
+    for (Signed_t i = 0; i < ARENA_CACHE_CLASSES; i++)
     {
-        mem[i] = 0;
+        if (size == (Unsigned_t)ARENA_BLOCK_SIZE << i)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* Lock and return the calling thread's shard of the block cache.
+ * Threads are handed shards round-robin the first time they use one */
+BlockCacheShard_t *lock_block_cache()
+{
+    if (thread_shard == 0)
+    {
+        thread_shard = (__atomic_fetch_add(&last_shard, 1, __ATOMIC_RELAXED) % ARENA_CACHE_SHARDS) + 1;
+    }
+
+    BlockCacheShard_t *shard = &block_cache[thread_shard - 1];
+    while (__atomic_exchange_n(&shard->locked, true, __ATOMIC_ACQUIRE))
+        ;
+
+    return shard;
+}
+
+void unlock_block_cache(BlockCacheShard_t *shard)
+{
+    __atomic_store_n(&shard->locked, false, __ATOMIC_RELEASE);
+}
+
+void init_block(ArenaBlock_t **block, Unsigned_t size)
+{
+    Signed_t class = block_class(size);
+    if (class >= 0)
+    {
+        BlockCacheShard_t *shard = lock_block_cache();
+        ArenaBlock_t *b = shard->blocks[class];
+        if (b != NULL)
+        {
+            shard->blocks[class] = b->next;
+            shard->cached -= size;
+        }
+        unlock_block_cache(shard);
+
+        /* The block's 'touched' mark is kept, so memory it handed
+         * out before is cleared before it is handed out again */
+        if (b != NULL)
+        {
+            b->start = block_data(b);
+            b->next = NULL;
+            *block = b;
+            return;
+        }
     }
 
+    /* calloc() hands back pre-zeroed pages for large blocks, so
+     * the block never needs to be cleared by hand */
+    Byte_t *mem = calloc(1, size + sizeof(ArenaBlock_t));
+    GLOBAL_STATS_RESERVE(size);
+
     *block = (ArenaBlock_t *)mem;
-    (*block)->start = (Byte_t *)((mem) + sizeof(ArenaBlock_t));
+    (*block)->start = block_data(*block);
     (*block)->end = (Byte_t *)(*block)->start + size;
+    (*block)->touched = (*block)->start;
     (*block)->next = NULL;
 }
 
+/* Hand a block back to the block cache, or to the system
+ * if the cache is full or doesn't take blocks of its size */
+void release_block(ArenaBlock_t *b)
+{
+    Unsigned_t size = (Unsigned_t)(b->end - block_data(b));
+    Signed_t class = block_class(size);
+    if (class >= 0)
+    {
+        BlockCacheShard_t *shard = lock_block_cache();
+        Boolean_t fits = shard->cached + size <= ARENA_CACHE_SHARD_SIZE;
+        if (fits)
+        {
+            b->next = shard->blocks[class];
+            shard->blocks[class] = b;
+            shard->cached += size;
+        }
+        unlock_block_cache(shard);
+
+        if (fits)
+        {
+            return;
+        }
+    }
+
+    GLOBAL_STATS_RELEASE(size);
+    free(b);
+}
+
+void FlushArenaBlockCache()
+{
+    for (Unsigned_t i = 0; i < ARENA_CACHE_SHARDS; i++)
+    {
+        BlockCacheShard_t *shard = &block_cache[i];
+        while (__atomic_exchange_n(&shard->locked, true, __ATOMIC_ACQUIRE))
+            ;
+
+        for (Signed_t class = 0; class < ARENA_CACHE_CLASSES; class ++)
+        {
+            for (ArenaBlock_t *b = shard->blocks[class]; b != NULL;)
+            {
+                ArenaBlock_t *last = b;
+                b = b->next;
+
+                GLOBAL_STATS_RELEASE((Unsigned_t)(last->end - block_data(last)));
+                free(last);
+            }
+            shard->blocks[class] = NULL;
+        }
+
+        shard->cached = 0;
+        unlock_block_cache(shard);
+    }
+}
+
+/* A thread's chunk within a concurrent arena */
+typedef struct _thread_chunk_s
+{
+    Arena_t *arena;
+    Unsigned_t generation;
+    ArenaBlock_t *chunk;
+} ThreadChunk_t;
+
+static __thread ThreadChunk_t thread_chunks[ARENA_THREAD_SLOTS];
+static Unsigned_t last_generation = 0;
+
 void ConstructArena(Arena_t *a)
 {
+    memset(a, 0, sizeof(Arena_t));
     init_block(&a->blocks, ARENA_BLOCK_SIZE);
+    a->current = a->blocks;
+    a->next_block_size = ARENA_BLOCK_SIZE * 2;
+    a->kind = ARENA_BLOCKS;
+}
+
+void ConstructConcurrentArena(Arena_t *a)
+{
+    memset(a, 0, sizeof(Arena_t));
+    a->next_block_size = ARENA_CHUNK_SIZE;
+    a->kind = ARENA_CONCURRENT;
+    a->generation = __atomic_add_fetch(&last_generation, 1, __ATOMIC_RELAXED);
+}
+
+void ConstructVirtualArena(Arena_t *a, Unsigned_t reserve, Boolean_t huge_pages)
+{
+    Unsigned_t page_size = (Unsigned_t)sysconf(_SC_PAGESIZE);
+    Unsigned_t alignment = huge_pages ? ARENA_HUGE_PAGE_SIZE : page_size;
+    reserve = AlignInteger(reserve, alignment);
+
+    /* Over-reserve, so the range can be trimmed to start on a huge page.
+     * The block header goes at the end of an extra page just before the
+     * aligned range, so the first allocation is aligned too */
+    Unsigned_t mapped = reserve + alignment;
+    Byte_t *mem = mmap(NULL, mapped, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    assert(mem != MAP_FAILED);
+
+    Byte_t *base = AlignPointer(mem + page_size, alignment);
+    if (base - page_size != mem)
+    {
+        munmap(mem, (Unsigned_t)(base - page_size - mem));
+    }
+
+    if (base + reserve != mem + mapped)
+    {
+        munmap(base + reserve, (Unsigned_t)((mem + mapped) - (base + reserve)));
+    }
+
+    if (huge_pages)
+    {
+        madvise(base, reserve, MADV_HUGEPAGE);
+    }
+
+    memset(a, 0, sizeof(Arena_t));
+    a->kind = ARENA_VIRTUAL;
+    a->reserve_end = base + reserve;
+    a->commit_size = huge_pages ? ARENA_HUGE_PAGE_SIZE : AlignInteger(ARENA_COMMIT_SIZE, page_size);
+
+    Unsigned_t committed = a->commit_size < reserve ? a->commit_size : reserve;
+    int status = mprotect(base - page_size, page_size + committed, PROT_READ | PROT_WRITE);
+    assert(status == 0);
+    GLOBAL_STATS_RESERVE(committed);
+
+    /* Freshly mapped pages are zero, so the block needs no clearing */
+    a->blocks = (ArenaBlock_t *)base - 1;
+    a->blocks->next = NULL;
+    a->blocks->start = block_data(a->blocks);
+    a->blocks->end = base + committed;
+    a->blocks->touched = a->blocks->start;
+    a->current = a->blocks;
 }
 
 void DeconstructArena(Arena_t *a)
 {
-    for (ArenaBlock_t *b = a->blocks; b != NULL;)
+    switch (a->kind)
     {
-        ArenaBlock_t *last = b;
-        b = b->next;
+    case ARENA_VIRTUAL:
+    {
+        Byte_t *header_page = block_data(a->blocks) - sysconf(_SC_PAGESIZE);
+        GLOBAL_STATS_RELEASE((Unsigned_t)(a->blocks->end - block_data(a->blocks)));
+        munmap(header_page, (Unsigned_t)(a->reserve_end - header_page));
+        break;
+    }
+    case ARENA_BLOCKS:
+    case ARENA_CONCURRENT:
+        for (ArenaBlock_t *b = a->blocks; b != NULL;)
+        {
+            ArenaBlock_t *last = b;
+            b = b->next;
 
-        free(last);
+            release_block(last);
+        }
+        break;
     }
 }
 
-void *ArenaAllocate(Arena_t *a, Unsigned_t size)
+/* The end of the first 'size' bytes of a virtual arena, rounded up to
+ * whole commits. Commits are counted from the start of the reserved
+ * range, not from address zero, since the range is only page aligned */
+Byte_t *virtual_commit_end(Arena_t *a, Unsigned_t size)
+{
+    Byte_t *base = block_data(a->blocks);
+    Byte_t *end = base + AlignInteger(size, a->commit_size);
+    return end > a->reserve_end ? a->reserve_end : end;
+}
+
+/* Slow path of ArenaAllocate for a virtual arena. Commit enough
+ * of the reserved range to fit 'size' more bytes */
+ArenaBlock_t *commit_virtual(Arena_t *a, Unsigned_t size)
+{
+    ArenaBlock_t *b = a->blocks;
+    a->current = b;
+
+    Byte_t *needed = (Byte_t *)AlignPointer(b->start, MACHINE_ALIGNMENT) + size;
+    assert(needed <= a->reserve_end);
+
+    Byte_t *new_end = virtual_commit_end(a, (Unsigned_t)(needed - block_data(b)));
+
+    int status = mprotect(b->end, (Unsigned_t)(new_end - b->end), PROT_READ | PROT_WRITE);
+    assert(status == 0);
+    GLOBAL_STATS_RESERVE((Unsigned_t)(new_end - b->end));
+
+    b->end = new_end;
+    return b;
+}
+
+/* Slow path of ArenaAllocate. Move on to the block after the current
+ * one if it was kept around by ArenaRewind and is large enough for
+ * 'size' bytes. Otherwise, link a new block in after the current block */
+ArenaBlock_t *grow_arena(Arena_t *a, Unsigned_t size)
+{
+    if (a->kind == ARENA_VIRTUAL)
+    {
+        return commit_virtual(a, size);
+    }
+
+    /* The current block is being left behind, along with whatever space is left in it */
+    if (a->current != NULL)
+    {
+        a->retired_used += (Unsigned_t)(a->current->start - block_data(a->current));
+    }
+
+    ArenaBlock_t *cached = a->current == NULL ? a->blocks : a->current->next;
+    if (cached != NULL && (Byte_t *)AlignPointer(cached->start, MACHINE_ALIGNMENT) + size <= cached->end)
+    {
+        a->current = cached;
+        return cached;
+    }
+
+    if (a->next_block_size < ARENA_BLOCK_SIZE)
+    {
+        a->next_block_size = ARENA_BLOCK_SIZE;
+    }
+
+    /* Leave room to align the start of the new block */
+    Unsigned_t block_size = size + MACHINE_ALIGNMENT;
+    if (block_size <= a->next_block_size)
+    {
+        block_size = a->next_block_size;
+        if (a->next_block_size < ARENA_BLOCK_MAX_SIZE)
+        {
+            a->next_block_size *= 2;
+        }
+    }
+
+    ArenaBlock_t *b;
+    init_block(&b, block_size);
+
+    b->next = cached;
+    if (a->current == NULL)
+    {
+        a->blocks = b;
+    }
+    else
+    {
+        a->current->next = b;
+    }
+
+    a->current = b;
+    return b;
+}
+
+/* Reserve 'size' bytes, aligned to 'alignment', from the arena's
+ * current block, growing the arena if the current block is full */
+void *arena_bump(Arena_t *a, Unsigned_t size, Unsigned_t alignment)
 {
-    if (a == &ARENA_NONE || a->blocks == ((void *)-1))
+    size = AlignInteger(size, MACHINE_ALIGNMENT);
+
+    ArenaBlock_t *b = a->current;
+    Byte_t *user_pointer = b == NULL ? NULL : AlignPointer(b->start, alignment);
+    if (b == NULL || user_pointer + size > b->end)
     {
-        return malloc(size);
+        b = grow_arena(a, size + alignment - MACHINE_ALIGNMENT);
+        user_pointer = AlignPointer(b->start, alignment);
     }
-    else if (a == &ARENA_PERM && a == NULL)
+
+    b->start = user_pointer + size;
+    return user_pointer;
+}
+
+/* Record that memory up to the block's bump pointer has been handed
+ * out. If 'zero' is set, clear the part of the allocation starting at
+ * 'user_pointer' that was handed out before, and so may be dirty */
+void touch_block(ArenaBlock_t *b, Byte_t *user_pointer, Boolean_t zero)
+{
+    if (zero && user_pointer < b->touched)
     {
-        ConstructArena(&ARENA_PERM);
+        Byte_t *dirty_end = b->touched < b->start ? b->touched : b->start;
+        memset(user_pointer, 0, (Unsigned_t)(dirty_end - user_pointer));
     }
 
+    if (b->touched < b->start)
+    {
+        b->touched = b->start;
+    }
+}
+
+/* Push a block onto the shared block list of a concurrent arena */
+void push_concurrent_block(Arena_t *a, ArenaBlock_t *b)
+{
+    b->next = __atomic_load_n(&a->blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&a->blocks, &b->next, b, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+}
+
+/* Reserve 'size' bytes from the calling thread's chunk of a concurrent
+ * arena. Only the calling thread allocates from its chunk, so the
+ * chunk's 'touched' mark can be updated without synchronization */
+void *concurrent_bump(Arena_t *a, Unsigned_t size, Unsigned_t alignment, Boolean_t zero)
+{
     size = AlignInteger(size, MACHINE_ALIGNMENT);
-    size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
 
-    ArenaBlock_t **b;
-    for (b = &a->blocks;; b = &((*b)->next))
+    ThreadChunk_t *tc = &thread_chunks[((Unsigned_t)a / sizeof(Arena_t)) % ARENA_THREAD_SLOTS];
+    ArenaBlock_t *b = tc->arena == a && tc->generation == a->generation ? tc->chunk : NULL;
+    Byte_t *user_pointer = b == NULL ? NULL : AlignPointer(b->start, alignment);
+
+    if (b == NULL || user_pointer + size > b->end)
     {
-        if ((*b) == NULL)
+        if (size + alignment > ARENA_CHUNK_SIZE / 4)
         {
-            init_block(b, size);
+            ArenaBlock_t *large;
+            init_block(&large, size + alignment);
+            push_concurrent_block(a, large);
+
+            user_pointer = AlignPointer(large->start, alignment);
+            large->start = user_pointer + size;
+            touch_block(large, user_pointer, zero);
+            return user_pointer;
         }
 
-        long area = (*b)->end - (*b)->start;
-        if (area >= size)
+        init_block(&b, ARENA_CHUNK_SIZE);
+        push_concurrent_block(a, b);
+
+        tc->arena = a;
+        tc->generation = a->generation;
+        tc->chunk = b;
+        user_pointer = AlignPointer(b->start, alignment);
+    }
+
+    b->start = user_pointer + size;
+    touch_block(b, user_pointer, zero);
+    return user_pointer;
+}
+
+/* Allocate 'size' bytes aligned to 'alignment' against any kind of
+ * arena, only clearing memory if 'zero' is set */
+void *allocate(Arena_t *a, Unsigned_t size, Unsigned_t alignment, Boolean_t zero)
+{
+    GLOBAL_STATS_ALLOCATE(size);
+
+    if (a->kind == ARENA_CONCURRENT)
+    {
+        return concurrent_bump(a, size, alignment, zero);
+    }
+    else if (a == &ARENA_NONE || a->blocks == ((void *)-1))
+    {
+        if (alignment == MACHINE_ALIGNMENT)
         {
-            break;
+            return zero ? calloc(1, size) : malloc(size);
+        }
+
+        void *user_pointer = NULL;
+        posix_memalign(&user_pointer, alignment, size);
+        if (zero && user_pointer != NULL)
+        {
+            memset(user_pointer, 0, size);
+        }
+
+        return user_pointer;
+    }
+
+    a->allocations++;
+    a->bytes_requested += size;
+
+    Byte_t *user_pointer = arena_bump(a, size, alignment);
+    touch_block(a->current, user_pointer, zero);
+
+    return user_pointer;
+}
+
+void *ArenaAllocate(Arena_t *a, Unsigned_t size)
+{
+    return allocate(a, size, MACHINE_ALIGNMENT, true);
+}
+
+void *ArenaAllocateUninit(Arena_t *a, Unsigned_t size)
+{
+    return allocate(a, size, MACHINE_ALIGNMENT, false);
+}
+
+void *ArenaAllocateAligned(Arena_t *a, Unsigned_t size, Unsigned_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    return allocate(a, size, alignment < MACHINE_ALIGNMENT ? MACHINE_ALIGNMENT : alignment, true);
+}
+
+/* Try to move the end of the most recent allocation in the current
+ * block, 'ptr', to 'new_end'. Returns false if 'ptr' isn't the most
+ * recent allocation, or the block can't fit 'new_end' */
+Boolean_t resize_in_place(Arena_t *a, Byte_t *ptr, Unsigned_t old_size, Byte_t *new_end)
+{
+    ArenaBlock_t *b = a->current;
+    if (b == NULL || ptr < block_data(b) || ptr + AlignInteger(old_size, MACHINE_ALIGNMENT) != b->start)
+    {
+        return false;
+    }
+
+    if (new_end > b->end)
+    {
+        if (a->kind != ARENA_VIRTUAL || new_end > a->reserve_end)
+        {
+            return false;
         }
+
+        commit_virtual(a, (Unsigned_t)(new_end - b->start));
+    }
+
+    b->start = new_end;
+    return true;
+}
+
+void *ArenaReallocate(Arena_t *a, void *ptr, Unsigned_t old_size, Unsigned_t new_size)
+{
+    if (ptr == NULL)
+    {
+        return ArenaAllocate(a, new_size);
     }
+    else if (a->kind != ARENA_CONCURRENT && (a == &ARENA_NONE || a->blocks == ((void *)-1)))
+    {
+        Byte_t *user_pointer = realloc(ptr, new_size);
+        if (user_pointer != NULL && new_size > old_size)
+        {
+            memset(user_pointer + old_size, 0, new_size - old_size);
+        }
 
-    void *user_pointer = (*b)->start;
-    (*b)->start += size;
+        return user_pointer;
+    }
 
-    memset(user_pointer, 0, size);
+    if (ArenaResizeInPlace(a, ptr, old_size, new_size))
+    {
+        return ptr;
+    }
+
+    Byte_t *user_pointer = allocate(a, new_size, MACHINE_ALIGNMENT, false);
+    memcpy(user_pointer, ptr, old_size < new_size ? old_size : new_size);
+
+    if (new_size > old_size)
+    {
+        memset(user_pointer + old_size, 0, new_size - old_size);
+    }
 
     return user_pointer;
-}
\ No newline at end of file
+}
+
+Boolean_t ArenaResizeInPlace(Arena_t *a, void *ptr, Unsigned_t old_size, Unsigned_t new_size)
+{
+    Byte_t *user_pointer = ptr;
+    if (a->kind == ARENA_CONCURRENT || a == &ARENA_NONE || a->blocks == ((void *)-1) ||
+        !resize_in_place(a, user_pointer, old_size, user_pointer + AlignInteger(new_size, MACHINE_ALIGNMENT)))
+    {
+        return false;
+    }
+
+    /* Only the part of the new tail that was handed out before can be dirty */
+    if (new_size > old_size)
+    {
+        touch_block(a->current, user_pointer + old_size, true);
+    }
+
+    return true;
+}
+
+/* The number of bytes handed out by a block or virtual arena */
+Unsigned_t arena_used(Arena_t *a)
+{
+    return a->retired_used + (a->current == NULL ? 0 : (Unsigned_t)(a->current->start - block_data(a->current)));
+}
+
+ArenaMark_t ArenaMark(Arena_t *a)
+{
+    ArenaMark_t mark = {a->current, a->current == NULL ? NULL : a->current->start};
+    return mark;
+}
+
+void ArenaRewind(Arena_t *a, ArenaMark_t mark)
+{
+    assert(a->kind != ARENA_CONCURRENT);
+    assert(mark.block == NULL || mark.block != a->current || mark.position <= mark.block->start);
+
+    Unsigned_t used = arena_used(a);
+    if (used > a->high_water)
+    {
+        a->high_water = used;
+    }
+
+    if (a->current != mark.block)
+    {
+        /* Empty every block used since the mark, but keep them linked
+         * after the marked block so they can be reused */
+        ArenaBlock_t *b = mark.block == NULL ? a->blocks : mark.block;
+        for (; b != a->current; b = b->next)
+        {
+            a->retired_used -= (Unsigned_t)(b->start - block_data(b));
+            b->start = block_data(b);
+        }
+        a->current->start = block_data(a->current);
+    }
+
+    if (mark.block != NULL)
+    {
+        mark.block->start = mark.position;
+    }
+
+    a->current = mark.block;
+}
+
+void ArenaReset(Arena_t *a)
+{
+    ArenaMark_t empty = {NULL, NULL};
+    ArenaRewind(a, empty);
+    a->current = a->blocks;
+}
+
+/* Give back the pages of a virtual arena past the first 'retain' bytes.
+ * They will read as zero if they are committed again */
+void decommit_virtual(Arena_t *a, Unsigned_t retain)
+{
+    ArenaBlock_t *b = a->blocks;
+    Unsigned_t keep = (Unsigned_t)(b->start - block_data(b)) + retain;
+    Byte_t *keep_end = virtual_commit_end(a, keep < a->commit_size ? a->commit_size : keep);
+
+    if (keep_end >= b->end)
+    {
+        return;
+    }
+
+    GLOBAL_STATS_RELEASE((Unsigned_t)(b->end - keep_end));
+    madvise(keep_end, (Unsigned_t)(b->end - keep_end), MADV_DONTNEED);
+    mprotect(keep_end, (Unsigned_t)(b->end - keep_end), PROT_NONE);
+
+    b->end = keep_end;
+    if (b->touched > keep_end)
+    {
+        b->touched = keep_end;
+    }
+}
+
+void ArenaResetTrim(Arena_t *a, Unsigned_t retain)
+{
+    ArenaReset(a);
+    if (a->blocks == NULL)
+    {
+        return;
+    }
+    else if (a->kind == ARENA_VIRTUAL)
+    {
+        decommit_virtual(a, retain);
+        return;
+    }
+
+    /* Always keep the first block, so the arena stays usable */
+    Unsigned_t retained = (Unsigned_t)(a->blocks->end - a->blocks->start);
+    ArenaBlock_t *last_kept = a->blocks;
+    while (last_kept->next != NULL)
+    {
+        Unsigned_t capacity = (Unsigned_t)(last_kept->next->end - last_kept->next->start);
+        if (retained + capacity > retain)
+        {
+            break;
+        }
+
+        retained += capacity;
+        last_kept = last_kept->next;
+    }
+
+    for (ArenaBlock_t *b = last_kept->next; b != NULL;)
+    {
+        ArenaBlock_t *last = b;
+        b = b->next;
+
+        release_block(last);
+    }
+    last_kept->next = NULL;
+}
+
+ArenaStats_t ArenaStats(Arena_t *a)
+{
+    ArenaStats_t stats = {0};
+    if (a->kind != ARENA_CONCURRENT && (a == &ARENA_NONE || a->blocks == ((void *)-1)))
+    {
+        return stats;
+    }
+
+    stats.allocations = a->allocations;
+    stats.bytes_requested = a->bytes_requested;
+
+    Boolean_t before_current = a->current != NULL;
+    for (ArenaBlock_t *b = a->blocks; b != NULL; b = b->next)
+    {
+        if (b == a->current)
+        {
+            before_current = false;
+        }
+        else if (before_current)
+        {
+            stats.bytes_wasted += (Unsigned_t)(b->end - b->start);
+        }
+
+        stats.block_count++;
+        stats.bytes_reserved += (Unsigned_t)(b->end - block_data(b));
+        stats.bytes_used += (Unsigned_t)(b->start - block_data(b));
+    }
+
+    stats.high_water = stats.bytes_used > a->high_water ? stats.bytes_used : a->high_water;
+    return stats;
+}
+
+#ifdef ARENA_STATS
+ArenaStats_t ArenaGlobalStats()
+{
+    ArenaStats_t stats = {0};
+    stats.allocations = __atomic_load_n(&global_stats.allocations, __ATOMIC_RELAXED);
+    stats.bytes_requested = __atomic_load_n(&global_stats.bytes_requested, __ATOMIC_RELAXED);
+    stats.bytes_reserved = __atomic_load_n(&global_stats.bytes_reserved, __ATOMIC_RELAXED);
+    stats.high_water = __atomic_load_n(&global_stats.high_water, __ATOMIC_RELAXED);
+    return stats;
+}
+#endif
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "basic_types.h"
+#include "linked_list.h"
+#include "bounded_queue.h"
+#include "mpsc_queue.h"
+
+#define BENCH_MESSAGES (1 << 21)
+#define BENCH_MAX_THREADS 8
+
+double bench_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+/* Every benchmark runs some producers and consumers, which
+ * between them hand over BENCH_MESSAGES messages */
+typedef struct
+{
+    BoundedQueue_t *queue;
+    MpscQueue_t *mpsc;
+    List_t *list;
+    pthread_mutex_t *lock;
+    Unsigned_t messages;
+    Unsigned_t sum;
+} BenchWorker_t;
+
+void run_bench(const char *name, Unsigned_t producers, Unsigned_t consumers,
+               void *(*producer)(void *), void *(*consumer)(void *), BenchWorker_t shared)
+{
+    pthread_t threads[2 * BENCH_MAX_THREADS];
+    BenchWorker_t workers[2 * BENCH_MAX_THREADS];
+
+    double start = bench_seconds();
+    for (Unsigned_t i = 0; i < producers + consumers; i++)
+    {
+        workers[i] = shared;
+        workers[i].messages = BENCH_MESSAGES / (i < producers ? producers : consumers);
+        pthread_create(&threads[i], NULL, i < producers ? producer : consumer, &workers[i]);
+    }
+
+    for (Unsigned_t i = 0; i < producers + consumers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = bench_seconds() - start;
+
+    printf("%-24s %2lu producers %2lu consumers %8.2f M messages/s\n",
+           name, producers, consumers, (double)BENCH_MESSAGES / elapsed / 1e6);
+}
+
+void *bounded_producer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages; i++)
+    {
+        BoundedQueuePush(w->queue, &i);
+    }
+
+    return NULL;
+}
+
+void *bounded_consumer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages; i++)
+    {
+        Unsigned_t value;
+        BoundedQueuePop(w->queue, &value);
+        w->sum += value;
+    }
+
+    return NULL;
+}
+
+void *locked_list_producer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages; i++)
+    {
+        ListNode_t *node = NewListNode(&ARENA_NONE, &i, sizeof(Unsigned_t));
+        pthread_mutex_lock(w->lock);
+        ListInsertBack(w->list, node);
+        pthread_mutex_unlock(w->lock);
+    }
+
+    return NULL;
+}
+
+void *locked_list_consumer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages;)
+    {
+        ListNode_t *node = NULL;
+        pthread_mutex_lock(w->lock);
+        if (w->list->first_element != NULL)
+        {
+            node = ListRemoveFront(w->list);
+        }
+        pthread_mutex_unlock(w->lock);
+
+        if (node == NULL)
+        {
+            sched_yield();
+            continue;
+        }
+
+        w->sum += *(Unsigned_t *)node->data;
+        free(node);
+        i++;
+    }
+
+    return NULL;
+}
+
+void bench_queues()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    for (Unsigned_t pairs = 1; pairs <= BENCH_MAX_THREADS; pairs *= 2)
+    {
+        BoundedQueue_t *queue = ArenaAllocateAligned(&a, sizeof(BoundedQueue_t), CACHE_LINE_SIZE);
+        ConstructBoundedQueue(queue, &a, sizeof(Unsigned_t), 1024);
+        run_bench("BoundedQueue_t", pairs, pairs, bounded_producer, bounded_consumer, (BenchWorker_t){.queue = queue});
+
+        List_t list = {NULL};
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        run_bench("List_t + mutex", pairs, pairs, locked_list_producer, locked_list_consumer,
+                  (BenchWorker_t){.list = &list, .lock = &lock});
+    }
+
+    DeconstructArena(&a);
+}
+
+void *mpsc_producer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages; i++)
+    {
+        MpscQueuePush(w->mpsc, NewListNode(&ARENA_NONE, &i, sizeof(Unsigned_t)));
+    }
+
+    return NULL;
+}
+
+void *mpsc_consumer(void *arg)
+{
+    BenchWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < w->messages;)
+    {
+        List_t batch = {NULL};
+        Unsigned_t count = MpscQueueDrain(w->mpsc, &batch, 64);
+        if (count == 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        for (Unsigned_t j = 0; j < count; j++)
+        {
+            ListNode_t *node = ListRemoveFront(&batch);
+            w->sum += *(Unsigned_t *)node->data;
+            free(node);
+        }
+        i += count;
+    }
+
+    return NULL;
+}
+
+/* Many producers feeding one consumer */
+void bench_fan_in()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    for (Unsigned_t producers = 1; producers <= BENCH_MAX_THREADS; producers *= 2)
+    {
+        MpscQueue_t *mpsc = ArenaAllocateAligned(&a, sizeof(MpscQueue_t), CACHE_LINE_SIZE);
+        ConstructMpscQueue(mpsc);
+        run_bench("MpscQueue_t", producers, 1, mpsc_producer, mpsc_consumer, (BenchWorker_t){.mpsc = mpsc});
+
+        List_t list = {NULL};
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        run_bench("List_t + mutex", producers, 1, locked_list_producer, locked_list_consumer,
+                  (BenchWorker_t){.list = &list, .lock = &lock});
+    }
+
+    DeconstructArena(&a);
+}
+
+int main()
+{
+    bench_queues();
+    bench_fan_in();
+    return 0;
+}
@@ -5,7 +5,12 @@
 
 MapNode_t *NewMapNode(Arena_t *arena, MapKey_t key, void *value, Unsigned_t length)
 {
-    MapNode_t *node = ArenaAllocate(arena, sizeof(MapNode_t) + length);
+    MapNode_t *node = value == NULL
+                          ? ArenaAllocate(arena, MAP_NODE_SIZE(length))
+                          : ArenaAllocateUninit(arena, MAP_NODE_SIZE(length));
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = NULL;
     node->key = key;
     node->length = length;
 
@@ -13,6 +18,26 @@ MapNode_t *NewMapNode(Arena_t *arena, MapKey_t key, void *value, Unsigned_t leng
     return node;
 }
 
+MapNode_t *NewPooledMapNode(Pool_t *pool, MapKey_t key, void *value, Unsigned_t length)
+{
+    assert(MAP_NODE_SIZE(length) <= pool->slot_size);
+
+    MapNode_t *node = PoolAllocate(pool);
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = NULL;
+    node->key = key;
+    node->length = length;
+
+    if (value == NULL)
+    {
+        memset(node->value, 0, length);
+    }
+
+    WriteMapNodeValue(node, value, length);
+    return node;
+}
+
 void WriteMapNodeValue(MapNode_t *mn, void *value, Unsigned_t length)
 {
     if (value == NULL || length == 0)
@@ -111,6 +136,71 @@ void InsertMapNode(Map_t *map, MapNode_t *node)
     insert_map_node(&map->root, node);
 }
 
+/* Put 'replacement' where 'node' hangs from its parent, or at the root */
+void replace_map_child(Map_t *map, MapNode_t *node, MapNode_t *replacement)
+{
+    if (node->parent == NULL)
+    {
+        map->root = replacement;
+    }
+    else if (node->parent->left == node)
+    {
+        node->parent->left = replacement;
+    }
+    else
+    {
+        node->parent->right = replacement;
+    }
+
+    if (replacement != NULL)
+    {
+        replacement->parent = node->parent;
+    }
+}
+
+MapNode_t *RemoveMapNode(Map_t *map, MapKey_t key)
+{
+    MapNode_t *node = lookup_node(map->root, key);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    if (node->left == NULL)
+    {
+        replace_map_child(map, node, node->right);
+    }
+    else if (node->right == NULL)
+    {
+        replace_map_child(map, node, node->left);
+    }
+    else
+    {
+        /* Take the node's successor out from under it, and put it in the node's place */
+        MapNode_t *successor = node->right;
+        while (successor->left != NULL)
+        {
+            successor = successor->left;
+        }
+
+        if (successor != node->right)
+        {
+            replace_map_child(map, successor, successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+
+        replace_map_child(map, node, successor);
+        successor->left = node->left;
+        successor->left->parent = successor;
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = NULL;
+    return node;
+}
+
 void compress(MapNode_t **root, unsigned long count)
 {
     MapNode_t *scanner = *root;
@@ -176,10 +266,22 @@ Unsigned_t flatten_map(MapNode_t **root)
     return length;
 }
 
+/* Fix every parent pointer after the tree has been rearranged. The
+ * node that ends up at the root may have had a parent before */
+void justify_root(MapNode_t *root)
+{
+    if (root != NULL)
+    {
+        root->parent = NULL;
+    }
+
+    justify_parents(root);
+}
+
 Unsigned_t FlattenMap(Map_t *map)
 {
     Unsigned_t ret_val = flatten_map(&map->root);
-    justify_parents(map->root);
+    justify_root(map->root);
     return ret_val;
 }
 
@@ -200,7 +302,7 @@ void balance_map(MapNode_t **root)
         compress(root, length / 2);
     }
 
-    justify_parents(*root);
+    justify_root(*root);
 }
 
 void BalanceMap(Map_t *map)
@@ -0,0 +1,152 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "bounded_queue.h"
+
+/**
+ * @private
+ * The head of every slot. The element follows it
+ */
+typedef struct _queue_slot_s
+{
+    Unsigned_t sequence;
+    Byte_t data[];
+} QueueSlot_t;
+
+void ConstructBoundedQueue(BoundedQueue_t *q, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity)
+{
+    Unsigned_t length = 2;
+    while (length < capacity)
+    {
+        length <<= 1;
+    }
+
+    q->arena = a;
+    q->slots = NewBuffer(a, AlignInteger(sizeof(QueueSlot_t) + data_width, sizeof(Unsigned_t)), length);
+    q->data_width = data_width;
+    q->mask = length - 1;
+    q->push_index = 0;
+    q->pop_index = 0;
+
+    /* Slot i is first pushed to when the push index reaches i */
+    for (Unsigned_t i = 0; i < length; i++)
+    {
+        ((QueueSlot_t *)BufferIndex(q->slots, i))->sequence = i;
+    }
+}
+
+void DeconstructBoundedQueue(BoundedQueue_t *q)
+{
+    if (q->arena == &ARENA_NONE || q->arena->blocks == ((void *)-1))
+    {
+        free(q->slots);
+    }
+
+    q->slots = NULL;
+}
+
+QueueSlot_t *queue_slot(BoundedQueue_t *q, Unsigned_t idx)
+{
+    return (QueueSlot_t *)&q->slots->data[(idx & q->mask) * q->slots->data_width];
+}
+
+/* Claim the next slot from the push or pop index, once the slot's sequence
+ * number is 'offset' past the index. Returns NULL if the slot is still a
+ * lap behind, meaning the queue is full (for pushes) or empty (for pops) */
+QueueSlot_t *queue_claim(BoundedQueue_t *q, Unsigned_t *index, Unsigned_t offset, Unsigned_t *claimed)
+{
+    Unsigned_t idx = __atomic_load_n(index, __ATOMIC_RELAXED);
+    while (true)
+    {
+        QueueSlot_t *slot = queue_slot(q, idx);
+        Unsigned_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        Signed_t difference = (Signed_t)(sequence - (idx + offset));
+
+        if (difference == 0)
+        {
+            /* On failure 'idx' is reloaded, and the new slot is tried */
+            if (__atomic_compare_exchange_n(index, &idx, idx + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *claimed = idx;
+                return slot;
+            }
+        }
+        else if (difference < 0)
+        {
+            return NULL;
+        }
+        else
+        {
+            /* Another thread claimed this slot already */
+            idx = __atomic_load_n(index, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+Boolean_t BoundedQueueTryPush(BoundedQueue_t *q, void *data)
+{
+    Unsigned_t idx;
+    QueueSlot_t *slot = queue_claim(q, &q->push_index, 0, &idx);
+    if (slot == NULL)
+    {
+        return false;
+    }
+
+    memcpy(slot->data, data, q->data_width);
+    __atomic_store_n(&slot->sequence, idx + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+Boolean_t BoundedQueueTryPop(BoundedQueue_t *q, void *dest)
+{
+    Unsigned_t idx;
+    QueueSlot_t *slot = queue_claim(q, &q->pop_index, 1, &idx);
+    if (slot == NULL)
+    {
+        return false;
+    }
+
+    /* Ready the slot to be pushed to on the next lap */
+    memcpy(dest, slot->data, q->data_width);
+    __atomic_store_n(&slot->sequence, idx + q->mask + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* Back off after a failed attempt at a blocking push or pop. Other
+ * targets spin without a hint to the processor */
+void queue_wait(Unsigned_t *attempts)
+{
+    if (*attempts < BOUNDED_QUEUE_SPIN_LIMIT)
+    {
+        (*attempts)++;
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+        return;
+    }
+
+    sched_yield();
+}
+
+void BoundedQueuePush(BoundedQueue_t *q, void *data)
+{
+    Unsigned_t attempts = 0;
+    while (!BoundedQueueTryPush(q, data))
+    {
+        queue_wait(&attempts);
+    }
+}
+
+void BoundedQueuePop(BoundedQueue_t *q, void *dest)
+{
+    Unsigned_t attempts = 0;
+    while (!BoundedQueueTryPop(q, dest))
+    {
+        queue_wait(&attempts);
+    }
+}
@@ -0,0 +1,318 @@
+#include <assert.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "buffer_search.h"
+
+/* The widest vector compared by the scans, and so the largest pattern they need */
+#define SCAN_VECTOR_SIZE 32
+
+/* Only widths that evenly divide a vector are scanned with vectors */
+Boolean_t scan_vector_width(Unsigned_t width)
+{
+    return width <= 8 && (width & (width - 1)) == 0;
+}
+
+/* Repeat an element across a whole vector */
+void scan_fill_pattern(Byte_t *pattern, void *value, Unsigned_t width)
+{
+    for (Unsigned_t i = 0; i < SCAN_VECTOR_SIZE; i += width)
+    {
+        memcpy(pattern + i, value, width);
+    }
+}
+
+/* Turn a mask with a bit set for every matching byte into one with a bit
+ * set at the first byte of every element whose bytes all match */
+uint32_t scan_element_mask(uint32_t bytes, Unsigned_t width)
+{
+    for (Unsigned_t shift = 1; shift < width; shift <<= 1)
+    {
+        bytes &= bytes >> shift;
+    }
+
+    return bytes & (uint32_t)(0xffffffffu / ((1u << width) - 1));
+}
+
+/* The scans take lengths in bytes, and return the byte offset of the
+ * first matching element, or 'length' if there is none */
+Unsigned_t scan_find_scalar(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    for (Unsigned_t i = 0; i < length; i += width)
+    {
+        if (memcmp(data + i, pattern, width) == 0)
+        {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+Unsigned_t scan_count_scalar(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    Unsigned_t count = 0;
+    for (Unsigned_t i = 0; i < length; i += width)
+    {
+        count += memcmp(data + i, pattern, width) == 0;
+    }
+
+    return count;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+Unsigned_t scan_find_sse2(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    __m128i needle = _mm_loadu_si128((__m128i *)pattern);
+
+    Unsigned_t i = 0;
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+    {
+        __m128i chunk = _mm_loadu_si128((__m128i *)(data + i));
+        uint32_t mask = scan_element_mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)), width);
+        if (mask != 0)
+        {
+            return i + (Unsigned_t)__builtin_ctz(mask);
+        }
+    }
+
+    return i + scan_find_scalar(data + i, length - i, pattern, width);
+}
+
+Unsigned_t scan_count_sse2(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    __m128i needle = _mm_loadu_si128((__m128i *)pattern);
+
+    Unsigned_t count = 0;
+    Unsigned_t i = 0;
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i))
+    {
+        __m128i chunk = _mm_loadu_si128((__m128i *)(data + i));
+        count += (Unsigned_t)__builtin_popcount(scan_element_mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)), width));
+    }
+
+    return count + scan_count_scalar(data + i, length - i, pattern, width);
+}
+
+__attribute__((target("avx2"))) Unsigned_t scan_find_avx2(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    __m256i needle = _mm256_loadu_si256((__m256i *)pattern);
+
+    Unsigned_t i = 0;
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+    {
+        __m256i chunk = _mm256_loadu_si256((__m256i *)(data + i));
+        uint32_t mask = scan_element_mask((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)), width);
+        if (mask != 0)
+        {
+            return i + (Unsigned_t)__builtin_ctz(mask);
+        }
+    }
+
+    return i + scan_find_sse2(data + i, length - i, pattern, width);
+}
+
+__attribute__((target("avx2,popcnt"))) Unsigned_t scan_count_avx2(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width)
+{
+    __m256i needle = _mm256_loadu_si256((__m256i *)pattern);
+
+    Unsigned_t count = 0;
+    Unsigned_t i = 0;
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i))
+    {
+        __m256i chunk = _mm256_loadu_si256((__m256i *)(data + i));
+        count += (Unsigned_t)__builtin_popcount(scan_element_mask((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)), width));
+    }
+
+    return count + scan_count_sse2(data + i, length - i, pattern, width);
+}
+
+static Unsigned_t (*scan_find)(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width) = scan_find_sse2;
+static Unsigned_t (*scan_count)(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width) = scan_count_sse2;
+#else
+/* Other targets scan one element at a time */
+static Unsigned_t (*scan_find)(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width) = scan_find_scalar;
+static Unsigned_t (*scan_count)(Byte_t *data, Unsigned_t length, Byte_t *pattern, Unsigned_t width) = scan_count_scalar;
+#endif
+
+__attribute__((constructor)) void select_scan()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        scan_find = scan_find_avx2;
+        scan_count = scan_count_avx2;
+    }
+#endif
+}
+
+Byte_t *RawByteFind(Byte_t *data, Unsigned_t length, Byte_t byte)
+{
+    Byte_t pattern[SCAN_VECTOR_SIZE];
+    memset(pattern, byte, sizeof(pattern));
+
+    Unsigned_t offset = scan_find(data, length, pattern, 1);
+    return offset == length ? NULL : data + offset;
+}
+
+Unsigned_t RawByteCount(Byte_t *data, Unsigned_t length, Byte_t byte)
+{
+    Byte_t pattern[SCAN_VECTOR_SIZE];
+    memset(pattern, byte, sizeof(pattern));
+
+    return scan_count(data, length, pattern, 1);
+}
+
+void *BufferFind(Buffer_t *b, void *value)
+{
+    Unsigned_t length = b->length * b->data_width;
+    if (length == 0)
+    {
+        return NULL;
+    }
+
+    Unsigned_t offset;
+    if (scan_vector_width(b->data_width))
+    {
+        Byte_t pattern[SCAN_VECTOR_SIZE];
+        scan_fill_pattern(pattern, value, b->data_width);
+        offset = scan_find(b->data, length, pattern, b->data_width);
+    }
+    else
+    {
+        offset = scan_find_scalar(b->data, length, value, b->data_width);
+    }
+
+    return offset == length ? NULL : b->data + offset;
+}
+
+Unsigned_t BufferCount(Buffer_t *b, void *value)
+{
+    Unsigned_t length = b->length * b->data_width;
+    if (length == 0)
+    {
+        return 0;
+    }
+    else if (!scan_vector_width(b->data_width))
+    {
+        return scan_count_scalar(b->data, length, value, b->data_width);
+    }
+
+    Byte_t pattern[SCAN_VECTOR_SIZE];
+    scan_fill_pattern(pattern, value, b->data_width);
+    return scan_count(b->data, length, pattern, b->data_width);
+}
+
+/* Each step halves the range without branching on the comparison, so
+ * there are no mispredictions, only a conditional move */
+Unsigned_t BufferLowerBound(Buffer_t *b, void *value, Comparator_t compare)
+{
+    Unsigned_t width = b->data_width;
+    Unsigned_t base = 0;
+    Unsigned_t n = b->length;
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    while (n > 1)
+    {
+        Unsigned_t half = n / 2;
+        base = compare(b->data + ((base + half) * width), value) < 0 ? base + half : base;
+        n -= half;
+    }
+
+    return base + (compare(b->data + (base * width), value) < 0);
+}
+
+/* Define a branchless lower bound over a buffer of one unsigned type.
+ * Both places the next step could look are prefetched, since the
+ * search does not know which it will take until the compare is done */
+#define DEFINE_LOWER_BOUND(NAME, TYPE)                                 \
+    static inline Unsigned_t NAME(Buffer_t *b, Unsigned_t key)         \
+    {                                                                  \
+        TYPE *values = (TYPE *)b->data;                                \
+        Unsigned_t base = 0;                                           \
+        Unsigned_t n = b->length;                                      \
+        while (n > 1)                                                  \
+        {                                                              \
+            Unsigned_t half = n / 2;                                   \
+            __builtin_prefetch(&values[base + (half / 2)]);            \
+            __builtin_prefetch(&values[base + half + (half / 2)]);     \
+            base = values[base + half] < key ? base + half : base;     \
+            n -= half;                                                 \
+        }                                                              \
+        return base + (values[base] < key);                            \
+    }
+
+DEFINE_LOWER_BOUND(lower_bound_u8, uint8_t)
+DEFINE_LOWER_BOUND(lower_bound_u16, uint16_t)
+DEFINE_LOWER_BOUND(lower_bound_u32, uint32_t)
+DEFINE_LOWER_BOUND(lower_bound_u64, uint64_t)
+
+Unsigned_t BufferLowerBoundUnsigned(Buffer_t *b, Unsigned_t key)
+{
+    if (b->length == 0)
+    {
+        return 0;
+    }
+
+    switch (b->data_width)
+    {
+    case 1:
+        return lower_bound_u8(b, key);
+    case 2:
+        return lower_bound_u16(b, key);
+    case 4:
+        return lower_bound_u32(b, key);
+    case 8:
+        return lower_bound_u64(b, key);
+    default:
+        assert(false && "Unsigned keys must be 1, 2, 4 or 8 bytes wide");
+        return 0;
+    }
+}
+
+/* Fill the subtree rooted at 'k' with the sorted elements from 'i'
+ * on, in order. Returns the index of the next unused sorted element */
+Unsigned_t eytzinger_fill(Buffer_t *eytzinger, Buffer_t *sorted, Unsigned_t i, Unsigned_t k)
+{
+    if (k >= eytzinger->length)
+    {
+        return i;
+    }
+
+    i = eytzinger_fill(eytzinger, sorted, i, 2 * k);
+    memcpy(&eytzinger->data[k * eytzinger->data_width], &sorted->data[i * sorted->data_width], sorted->data_width);
+    return eytzinger_fill(eytzinger, sorted, i + 1, (2 * k) + 1);
+}
+
+Buffer_t *NewEytzingerBuffer(Arena_t *a, Buffer_t *sorted)
+{
+    Buffer_t *eytzinger = NewBuffer(a, sorted->data_width, sorted->length + 1);
+    eytzinger_fill(eytzinger, sorted, 0, 1);
+    return eytzinger;
+}
+
+void *EytzingerLowerBound(Buffer_t *eytzinger, void *value, Comparator_t compare)
+{
+    Unsigned_t width = eytzinger->data_width;
+    Unsigned_t k = 1;
+    while (k < eytzinger->length)
+    {
+        /* Near the bottom of the tree the descendants are past the end
+         * of the buffer, so prefetch the root instead of a wild address */
+        Unsigned_t ahead = k << SEARCH_PREFETCH_DISTANCE;
+        __builtin_prefetch(&eytzinger->data[(ahead < eytzinger->length ? ahead : 0) * width]);
+        k = (2 * k) + (compare(&eytzinger->data[k * width], value) < 0);
+    }
+
+    /* Every step right past the answer set a trailing one bit, and the
+     * step left onto it a zero. Strip them to get back to the answer */
+    k >>= __builtin_ffsll((long long)~k);
+    return k == 0 ? NULL : &eytzinger->data[k * width];
+}
@@ -0,0 +1,348 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "buffer_sort.h"
+
+void sort_swap(Byte_t *x, Byte_t *y, Unsigned_t width)
+{
+    if (width == sizeof(Unsigned_t))
+    {
+        Unsigned_t tmp;
+        memcpy(&tmp, x, sizeof(Unsigned_t));
+        memcpy(x, y, sizeof(Unsigned_t));
+        memcpy(y, &tmp, sizeof(Unsigned_t));
+        return;
+    }
+
+    Byte_t tmp[64];
+    while (width > 0)
+    {
+        Unsigned_t chunk = width < sizeof(tmp) ? width : sizeof(tmp);
+        memcpy(tmp, x, chunk);
+        memcpy(x, y, chunk);
+        memcpy(y, tmp, chunk);
+
+        x += chunk;
+        y += chunk;
+        width -= chunk;
+    }
+}
+
+/* Stable, so it is also used to build the initial runs of the merge sort */
+void sort_insertion(Byte_t *base, Unsigned_t count, Unsigned_t width, Comparator_t compare)
+{
+    for (Unsigned_t i = 1; i < count; i++)
+    {
+        for (Byte_t *e = base + (i * width); e > base && compare(e - width, e) > 0; e -= width)
+        {
+            sort_swap(e - width, e, width);
+        }
+    }
+}
+
+void sort_sift_down(Byte_t *base, Unsigned_t root, Unsigned_t count, Unsigned_t width, Comparator_t compare)
+{
+    for (Unsigned_t child = (2 * root) + 1; child < count; child = (2 * root) + 1)
+    {
+        if (child + 1 < count && compare(base + (child * width), base + ((child + 1) * width)) < 0)
+        {
+            child++;
+        }
+
+        if (compare(base + (root * width), base + (child * width)) >= 0)
+        {
+            return;
+        }
+
+        sort_swap(base + (root * width), base + (child * width), width);
+        root = child;
+    }
+}
+
+void sort_heap(Byte_t *base, Unsigned_t count, Unsigned_t width, Comparator_t compare)
+{
+    for (Unsigned_t i = count / 2; i > 0; i--)
+    {
+        sort_sift_down(base, i - 1, count, width, compare);
+    }
+
+    for (Unsigned_t end = count - 1; end > 0; end--)
+    {
+        sort_swap(base, base + (end * width), width);
+        sort_sift_down(base, 0, end, width, compare);
+    }
+}
+
+void sort_intro(Byte_t *base, Unsigned_t count, Unsigned_t width, Comparator_t compare, Unsigned_t depth)
+{
+    while (count > BUFFER_SORT_INSERTION_THRESHOLD)
+    {
+        /* Partitioning is going badly, fall back to a heap sort */
+        if (depth == 0)
+        {
+            sort_heap(base, count, width, compare);
+            return;
+        }
+        depth--;
+
+        /* Order the first, middle and last elements, then use the middle one as the pivot */
+        Byte_t *middle = base + ((count / 2) * width);
+        Byte_t *last = base + ((count - 1) * width);
+        if (compare(middle, base) < 0)
+        {
+            sort_swap(middle, base, width);
+        }
+        if (compare(last, middle) < 0)
+        {
+            sort_swap(last, middle, width);
+            if (compare(middle, base) < 0)
+            {
+                sort_swap(middle, base, width);
+            }
+        }
+        sort_swap(base, middle, width);
+
+        /* Hoare partition around the pivot, which is now at 'base'.
+         * Both scans stop on elements equal to the pivot, so runs
+         * of equal elements are split evenly */
+        Unsigned_t i = 0;
+        Unsigned_t j = count;
+        while (true)
+        {
+            do
+            {
+                i++;
+            } while (i < count && compare(base + (i * width), base) < 0);
+
+            do
+            {
+                j--;
+            } while (compare(base + (j * width), base) > 0);
+
+            if (i >= j)
+            {
+                break;
+            }
+
+            sort_swap(base + (i * width), base + (j * width), width);
+        }
+        sort_swap(base, base + (j * width), width);
+
+        /* Recurse into the smaller side, so the stack stays O(log n) deep */
+        Unsigned_t left_count = j;
+        Unsigned_t right_count = count - j - 1;
+        Byte_t *right = base + ((j + 1) * width);
+        if (left_count < right_count)
+        {
+            sort_intro(base, left_count, width, compare, depth);
+            base = right;
+            count = right_count;
+        }
+        else
+        {
+            sort_intro(right, right_count, width, compare, depth);
+            count = left_count;
+        }
+    }
+
+    sort_insertion(base, count, width, compare);
+}
+
+/* Allow twice the depth of a perfectly balanced partitioning before giving up on it */
+Unsigned_t sort_depth(Unsigned_t count)
+{
+    Unsigned_t depth = 0;
+    for (; count > 1; count >>= 1)
+    {
+        depth += 2;
+    }
+
+    return depth;
+}
+
+void BufferSort(Buffer_t *b, Comparator_t compare)
+{
+    sort_intro(b->data, b->length, b->data_width, compare, sort_depth(b->length));
+}
+
+void BufferSliceSort(BufferSlice_t *s, Comparator_t compare)
+{
+    sort_intro(s->data, s->length, s->data_width, compare, sort_depth(s->length));
+}
+
+/* Scratch space is rewound off the arena once the sort is done,
+ * or free'd when it came from ARENA_NONE */
+void *sort_scratch_allocate(Arena_t *scratch, ArenaMark_t *mark, Unsigned_t size)
+{
+    if (scratch != &ARENA_NONE && scratch->blocks != ((void *)-1))
+    {
+        *mark = ArenaMark(scratch);
+    }
+
+    return ArenaAllocateUninit(scratch, size);
+}
+
+void sort_scratch_release(Arena_t *scratch, ArenaMark_t mark, void *space)
+{
+    if (scratch == &ARENA_NONE || scratch->blocks == ((void *)-1))
+    {
+        free(space);
+        return;
+    }
+
+    ArenaRewind(scratch, mark);
+}
+
+void sort_merge(Byte_t *dest, Byte_t *left, Byte_t *middle, Byte_t *end, Unsigned_t width, Comparator_t compare)
+{
+    Byte_t *right = middle;
+    while (left < middle && right < end)
+    {
+        /* Take from the left on ties, to keep the sort stable */
+        if (compare(right, left) < 0)
+        {
+            memcpy(dest, right, width);
+            right += width;
+        }
+        else
+        {
+            memcpy(dest, left, width);
+            left += width;
+        }
+        dest += width;
+    }
+
+    memcpy(dest, left, (Unsigned_t)(middle - left));
+    dest += middle - left;
+    memcpy(dest, right, (Unsigned_t)(end - right));
+}
+
+void BufferStableSort(Buffer_t *b, Comparator_t compare, Arena_t *scratch)
+{
+    Unsigned_t width = b->data_width;
+    Unsigned_t count = b->length;
+    Unsigned_t run = BUFFER_SORT_INSERTION_THRESHOLD;
+
+    for (Unsigned_t i = 0; i < count; i += run)
+    {
+        sort_insertion(b->data + (i * width), count - i < run ? count - i : run, width, compare);
+    }
+
+    if (count <= run)
+    {
+        return;
+    }
+
+    ArenaMark_t mark = {NULL, NULL};
+    Byte_t *src = b->data;
+    Byte_t *dest = sort_scratch_allocate(scratch, &mark, count * width);
+    Byte_t *space = dest;
+
+    /* Merge runs back and forth between the buffer and the scratch space */
+    for (; run < count; run *= 2)
+    {
+        for (Unsigned_t i = 0; i < count; i += 2 * run)
+        {
+            Unsigned_t middle = i + run < count ? i + run : count;
+            Unsigned_t end = middle + run < count ? middle + run : count;
+            sort_merge(dest + (i * width), src + (i * width), src + (middle * width), src + (end * width), width, compare);
+        }
+
+        Byte_t *tmp = src;
+        src = dest;
+        dest = tmp;
+    }
+
+    if (src != b->data)
+    {
+        memcpy(b->data, src, count * width);
+    }
+
+    sort_scratch_release(scratch, mark, space);
+}
+
+/* One LSD radix sort for each key width. Every digit is counted in a
+ * single pass over the keys, and passes where every key has the same
+ * digit are skipped, since they would not move anything */
+#define RADIX_SORT(TYPE, DATA, SPACE, COUNT)                                                 \
+    do                                                                                       \
+    {                                                                                        \
+        enum                                                                                 \
+        {                                                                                    \
+            DIGITS = (sizeof(TYPE) * 8) / BUFFER_RADIX_BITS                                  \
+        };                                                                                   \
+        Unsigned_t counts[DIGITS][1 << BUFFER_RADIX_BITS] = {{0}};                           \
+        TYPE *src = (TYPE *)(DATA);                                                          \
+        TYPE *dest = (TYPE *)(SPACE);                                                        \
+                                                                                             \
+        for (Unsigned_t i = 0; i < (COUNT); i++)                                             \
+        {                                                                                    \
+            for (Unsigned_t d = 0; d < DIGITS; d++)                                          \
+            {                                                                                \
+                counts[d][(src[i] >> (d * BUFFER_RADIX_BITS)) & ((1 << BUFFER_RADIX_BITS) - 1)]++; \
+            }                                                                                \
+        }                                                                                    \
+                                                                                             \
+        for (Unsigned_t d = 0; d < DIGITS; d++)                                              \
+        {                                                                                    \
+            Unsigned_t shift = d * BUFFER_RADIX_BITS;                                        \
+            if (counts[d][(src[0] >> shift) & ((1 << BUFFER_RADIX_BITS) - 1)] == (COUNT))    \
+            {                                                                                \
+                continue;                                                                    \
+            }                                                                                \
+                                                                                             \
+            Unsigned_t offset = 0;                                                           \
+            for (Unsigned_t k = 0; k < (1 << BUFFER_RADIX_BITS); k++)                        \
+            {                                                                                \
+                Unsigned_t digit_count = counts[d][k];                                       \
+                counts[d][k] = offset;                                                       \
+                offset += digit_count;                                                       \
+            }                                                                                \
+                                                                                             \
+            for (Unsigned_t i = 0; i < (COUNT); i++)                                         \
+            {                                                                                \
+                dest[counts[d][(src[i] >> shift) & ((1 << BUFFER_RADIX_BITS) - 1)]++] = src[i]; \
+            }                                                                                \
+                                                                                             \
+            TYPE *tmp = src;                                                                 \
+            src = dest;                                                                      \
+            dest = tmp;                                                                      \
+        }                                                                                    \
+                                                                                             \
+        if (src != (TYPE *)(DATA))                                                           \
+        {                                                                                    \
+            memcpy((DATA), src, (COUNT) * sizeof(TYPE));                                     \
+        }                                                                                    \
+    } while (0)
+
+void BufferRadixSort(Buffer_t *b, Arena_t *scratch)
+{
+    if (b->length <= 1)
+    {
+        return;
+    }
+
+    ArenaMark_t mark = {NULL, NULL};
+    void *space = sort_scratch_allocate(scratch, &mark, b->length * b->data_width);
+
+    switch (b->data_width)
+    {
+    case 1:
+        RADIX_SORT(uint8_t, b->data, space, b->length);
+        break;
+    case 2:
+        RADIX_SORT(uint16_t, b->data, space, b->length);
+        break;
+    case 4:
+        RADIX_SORT(uint32_t, b->data, space, b->length);
+        break;
+    case 8:
+        RADIX_SORT(uint64_t, b->data, space, b->length);
+        break;
+    default:
+        assert(false && "Radix sort keys must be 1, 2, 4 or 8 bytes wide");
+    }
+
+    sort_scratch_release(scratch, mark, space);
+}
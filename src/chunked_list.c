@@ -0,0 +1,243 @@
+#include "chunked_list.h"
+
+#include <string.h>
+#include <assert.h>
+
+void ConstructChunkedList(ChunkedList_t *list, Arena_t *arena, Unsigned_t data_width)
+{
+    assert(data_width > 0);
+
+    Unsigned_t capacity = (CHUNKED_LIST_CHUNK_SIZE - sizeof(ListChunk_t)) / data_width;
+    capacity = capacity > 0 ? capacity : 1;
+
+    list->data_width = data_width;
+    list->length = 0;
+    list->chunk_capacity = capacity;
+    list->first_chunk = NULL;
+    ConstructAlignedPool(&list->chunks, arena, sizeof(ListChunk_t) + (capacity * data_width), CACHE_LINE_SIZE);
+}
+
+Byte_t *chunk_slot(ChunkedList_t *list, ListChunk_t *chunk, Unsigned_t slot)
+{
+    return &chunk->data[slot * list->data_width];
+}
+
+/* Take a new, empty chunk, and link it in at the back of the list.
+ * Elements will be added to it from slot 'start' */
+ListChunk_t *link_new_chunk(ChunkedList_t *list, Unsigned_t start)
+{
+    ListChunk_t *chunk = PoolAllocate(&list->chunks);
+    chunk->start = start;
+    chunk->count = 0;
+
+    if (list->first_chunk == NULL)
+    {
+        chunk->next = chunk;
+        chunk->previous = chunk;
+        list->first_chunk = chunk;
+        return chunk;
+    }
+
+    ListChunk_t *last = list->first_chunk->previous;
+    chunk->next = list->first_chunk;
+    chunk->previous = last;
+    last->next = chunk;
+    list->first_chunk->previous = chunk;
+    return chunk;
+}
+
+/* Unlink a chunk that has been emptied, and give it back to the pool */
+void unlink_chunk(ChunkedList_t *list, ListChunk_t *chunk)
+{
+    if (chunk->next == chunk)
+    {
+        list->first_chunk = NULL;
+    }
+    else
+    {
+        chunk->previous->next = chunk->next;
+        chunk->next->previous = chunk->previous;
+        if (list->first_chunk == chunk)
+        {
+            list->first_chunk = chunk->next;
+        }
+    }
+
+    PoolFree(&list->chunks, chunk);
+}
+
+void *ChunkedListInsertBack(ChunkedList_t *list, void *data)
+{
+    ListChunk_t *last = list->first_chunk == NULL ? NULL : list->first_chunk->previous;
+    if (last == NULL || last->start + last->count == list->chunk_capacity)
+    {
+        last = link_new_chunk(list, 0);
+    }
+
+    Byte_t *element = chunk_slot(list, last, last->start + last->count);
+    last->count++;
+    list->length++;
+
+    if (data != NULL)
+    {
+        memcpy(element, data, list->data_width);
+    }
+
+    return element;
+}
+
+void *ChunkedListInsertFront(ChunkedList_t *list, void *data)
+{
+    ListChunk_t *first = list->first_chunk;
+    if (first == NULL || first->start == 0)
+    {
+        /* Fill the new chunk from its end, so more elements can go in front */
+        first = link_new_chunk(list, list->chunk_capacity);
+        list->first_chunk = first;
+    }
+
+    first->start--;
+    first->count++;
+    list->length++;
+
+    Byte_t *element = chunk_slot(list, first, first->start);
+    if (data != NULL)
+    {
+        memcpy(element, data, list->data_width);
+    }
+
+    return element;
+}
+
+void ChunkedListRemoveBack(ChunkedList_t *list, void *dest)
+{
+    assert(list->length > 0);
+    ListChunk_t *last = list->first_chunk->previous;
+
+    last->count--;
+    list->length--;
+    if (dest != NULL)
+    {
+        memcpy(dest, chunk_slot(list, last, last->start + last->count), list->data_width);
+    }
+
+    if (last->count == 0)
+    {
+        unlink_chunk(list, last);
+    }
+}
+
+void ChunkedListRemoveFront(ChunkedList_t *list, void *dest)
+{
+    assert(list->length > 0);
+    ListChunk_t *first = list->first_chunk;
+
+    if (dest != NULL)
+    {
+        memcpy(dest, chunk_slot(list, first, first->start), list->data_width);
+    }
+
+    first->start++;
+    first->count--;
+    list->length--;
+
+    if (first->count == 0)
+    {
+        unlink_chunk(list, first);
+    }
+}
+
+Unsigned_t ChunkedListLength(ChunkedList_t *list)
+{
+    return list->length;
+}
+
+void *ChunkedListIndex(ChunkedList_t *list, Unsigned_t idx)
+{
+    assert(idx < list->length);
+
+    if (idx < list->length / 2)
+    {
+        ListChunk_t *chunk = list->first_chunk;
+        while (idx >= chunk->count)
+        {
+            idx -= chunk->count;
+            chunk = chunk->next;
+        }
+
+        return chunk_slot(list, chunk, chunk->start + idx);
+    }
+
+    /* Closer to the back, so count back from the last element */
+    Unsigned_t from_back = list->length - 1 - idx;
+    ListChunk_t *chunk = list->first_chunk->previous;
+    while (from_back >= chunk->count)
+    {
+        from_back -= chunk->count;
+        chunk = chunk->previous;
+    }
+
+    return chunk_slot(list, chunk, chunk->start + chunk->count - 1 - from_back);
+}
+
+typedef struct _chunked_list_iterator_opaque_s
+{
+    ChunkedList_t *list;
+    ListChunk_t *chunk;
+    Unsigned_t slot;
+    Unsigned_t position;
+} ChunkedListItOpaque_t;
+
+_Static_assert(sizeof(ChunkedListItOpaque_t) <= IT_OPAQUE_DATA_SIZE, "Chunked list iterator opaque size too large");
+
+void ChunkedListIteratorNext(ChunkedListItOpaque_t *opaque)
+{
+    opaque->position++;
+    opaque->slot++;
+    if (opaque->slot == opaque->chunk->count)
+    {
+        opaque->chunk = opaque->chunk->next;
+        opaque->slot = 0;
+    }
+}
+
+void ChunkedListIteratorPrev(ChunkedListItOpaque_t *opaque)
+{
+    opaque->position--;
+    if (opaque->slot == 0)
+    {
+        opaque->chunk = opaque->chunk->previous;
+        opaque->slot = opaque->chunk->count;
+    }
+    opaque->slot--;
+}
+
+/* Stepping back from the first element wraps the position around, so it is past the end too */
+bool ChunkedListIteratorDone(ChunkedListItOpaque_t *opaque)
+{
+    return opaque->position >= opaque->list->length;
+}
+
+void *ChunkedListIteratorItem(ChunkedListItOpaque_t *opaque)
+{
+    return chunk_slot(opaque->list, opaque->chunk, opaque->chunk->start + opaque->slot);
+}
+
+Iterator_t NewChunkedListIterator(ChunkedList_t *list)
+{
+    Iterator_t it = {
+        (IteratorMove_t)ChunkedListIteratorNext,
+        (IteratorMove_t)ChunkedListIteratorPrev,
+        (IteratorDone_t)ChunkedListIteratorDone,
+        (IteratorItem_t)ChunkedListIteratorItem,
+        NULL,
+    };
+
+    ChunkedListItOpaque_t *opaque = (ChunkedListItOpaque_t *)it.opaque_data;
+    opaque->list = list;
+    opaque->chunk = list->first_chunk;
+    opaque->slot = 0;
+    opaque->position = 0;
+
+    return it;
+}
@@ -19,33 +19,25 @@ ConstantObject_t *NewConstant(ConstantPool_t *pool, void *value, Unsigned_t leng
     Unsigned_t bucket_hash = RawBufferHash(buff, length);
     Unsigned_t bucket_idx = bucket_hash % NUM_INTERN_BUCKETS;
 
-    ListNode_t **b;
-    for (b = &(pool->buckets[bucket_idx].first_element); *b != NULL; b = &((*b)->next))
+    /* Buckets are circular lists, so stop after coming back around to the first node */
+    List_t *bucket_list = &pool->buckets[bucket_idx];
+    ListNode_t *b = bucket_list->first_element;
+    while (b != NULL)
     {
-        ConstantObject_t *stored_obj = (ConstantObject_t *)(*b)->data;
-        if ((stored_obj->hash != bucket_hash) || (stored_obj->length != length))
-        {
-            continue;
-        }
+        ConstantObject_t *stored_obj = (ConstantObject_t *)b->data;
 
         /* If we've seen this string before, return original copy */
-        Unsigned_t i;
-        for (i = 0; i < length; i++)
-        {
-            if (stored_obj->value[i] != buff[i])
-            {
-                break;
-            }
-        }
-
-        if (i == length)
+        if (stored_obj->hash == bucket_hash && stored_obj->length == length &&
+            memcmp(stored_obj->value, buff, length) == 0)
         {
             return stored_obj;
         }
+
+        b = b->next == bucket_list->first_element ? NULL : b->next;
     }
 
     ListNode_t *bucket = NewListNode(pool->arena, NULL, length + sizeof(ConstantObject_t));
-    *b = bucket;
+    ListInsertBack(bucket_list, bucket);
 
     ConstantObject_t *obj = (ConstantObject_t *)bucket->data;
     obj->length = length;
@@ -1,5 +1,6 @@
 #include <string.h>
 #include "constant_string.h"
+#include "buffer_search.h"
 
 String_t *NewString(char *str)
 {
@@ -54,4 +55,14 @@ Iterator_t NewStringIterator(String_t *s)
     opaque->str = s;
 
     return it;
-}
\ No newline at end of file
+}
+
+Character_t *StringFind(String_t *s, Character_t c)
+{
+    return (Character_t *)RawByteFind(s->value, s->length, (Byte_t)c);
+}
+
+Unsigned_t StringCount(String_t *s, Character_t c)
+{
+    return RawByteCount(s->value, s->length, (Byte_t)c);
+}
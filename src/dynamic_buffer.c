@@ -0,0 +1,97 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "dynamic_buffer.h"
+
+void ConstructDynamicBuffer(DynamicBuffer_t *db, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity)
+{
+    db->arena = a;
+    db->capacity = capacity;
+    db->buffer = ArenaAllocateUninit(a, sizeof(Buffer_t) + (capacity * data_width));
+    db->buffer->data_width = data_width;
+    db->buffer->length = 0;
+}
+
+void DeconstructDynamicBuffer(DynamicBuffer_t *db)
+{
+    if (db->arena == &ARENA_NONE || db->arena->blocks == ((void *)-1))
+    {
+        free(db->buffer);
+    }
+
+    db->buffer = NULL;
+    db->capacity = 0;
+}
+
+/* Move the buffer to one with room for exactly 'capacity' elements */
+void resize_dynamic_buffer(DynamicBuffer_t *db, Unsigned_t capacity)
+{
+    Unsigned_t width = db->buffer->data_width;
+    db->buffer = ArenaReallocate(db->arena, db->buffer,
+                                 sizeof(Buffer_t) + (db->capacity * width),
+                                 sizeof(Buffer_t) + (capacity * width));
+    db->capacity = capacity;
+}
+
+void DynamicBufferReserve(DynamicBuffer_t *db, Unsigned_t capacity)
+{
+    if (capacity > db->capacity)
+    {
+        resize_dynamic_buffer(db, capacity);
+    }
+}
+
+void DynamicBufferShrink(DynamicBuffer_t *db)
+{
+    if (db->buffer->length < db->capacity)
+    {
+        resize_dynamic_buffer(db, db->buffer->length);
+    }
+}
+
+void *DynamicBufferPush(DynamicBuffer_t *db, void *data)
+{
+    Buffer_t *b = db->buffer;
+    if (b->length == db->capacity)
+    {
+        /* 'data' may be an element of this buffer, which is about to move */
+        Byte_t *source = data;
+        Boolean_t aliased = source >= b->data && source < b->data + (b->length * b->data_width);
+        Unsigned_t offset = aliased ? (Unsigned_t)(source - b->data) : 0;
+
+        Unsigned_t capacity = db->capacity * 2;
+        resize_dynamic_buffer(db, capacity > DYNAMIC_BUFFER_MIN_CAPACITY ? capacity : DYNAMIC_BUFFER_MIN_CAPACITY);
+        b = db->buffer;
+
+        if (aliased)
+        {
+            data = b->data + offset;
+        }
+    }
+
+    void *element = &b->data[b->length * b->data_width];
+    b->length++;
+
+    if (data == NULL)
+    {
+        memset(element, 0, b->data_width);
+    }
+    else
+    {
+        memcpy(element, data, b->data_width);
+    }
+
+    return element;
+}
+
+void DynamicBufferPop(DynamicBuffer_t *db, void *dest)
+{
+    Buffer_t *b = db->buffer;
+    assert(b->length > 0);
+
+    if (dest != NULL)
+    {
+        BufferCopyElement(b, dest, b->length - 1);
+    }
+    b->length--;
+}
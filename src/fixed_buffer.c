@@ -1,14 +1,60 @@
 #include <assert.h>
+#include <stdlib.h>
 #include "fixed_buffer.h"
 
 Buffer_t *NewBuffer(Arena_t *a, Unsigned_t data_width, Unsigned_t length)
 {
-    Buffer_t *b = ArenaAllocate(a, length * data_width);
+    Buffer_t *b = ArenaAllocate(a, sizeof(Buffer_t) + (length * data_width));
     b->length = length;
     b->data_width = data_width;
     return b;
 }
 
+Buffer_t *NewAlignedBuffer(Arena_t *a, Unsigned_t data_width, Unsigned_t length, Unsigned_t alignment)
+{
+    if (alignment <= sizeof(Buffer_t))
+    {
+        return NewBuffer(a, data_width, length);
+    }
+
+    /* Place the header just before the aligned data */
+    Byte_t *memory = ArenaAllocateAligned(a, alignment + (length * data_width), alignment);
+    return InitializeBuffer(memory + alignment - sizeof(Buffer_t), data_width, length);
+}
+
+Buffer_t *ResizeBuffer(Arena_t *a, Buffer_t *b, Unsigned_t length)
+{
+    Buffer_t *new_b = ArenaReallocate(a, b, TOTAL_BUFFER_SIZE(b), sizeof(Buffer_t) + (length * b->data_width));
+    new_b->length = length;
+    return new_b;
+}
+
+Buffer_t *ResizeAlignedBuffer(Arena_t *a, Buffer_t *b, Unsigned_t length, Unsigned_t alignment)
+{
+    if (alignment <= sizeof(Buffer_t))
+    {
+        return ResizeBuffer(a, b, length);
+    }
+
+    /* The allocation starts 'alignment' bytes before the data */
+    Unsigned_t data_width = b->data_width;
+    Byte_t *memory = b->data - alignment;
+    if (ArenaResizeInPlace(a, memory, alignment + (b->length * data_width), alignment + (length * data_width)))
+    {
+        b->length = length;
+        return b;
+    }
+
+    Buffer_t *new_b = NewAlignedBuffer(a, data_width, length, alignment);
+    memcpy(new_b->data, b->data, (length < b->length ? length : b->length) * data_width);
+    if (a == &ARENA_NONE || a->blocks == ((void *)-1))
+    {
+        free(memory);
+    }
+
+    return new_b;
+}
+
 Buffer_t *InitializeBuffer(Byte_t *memory, Unsigned_t data_width, Unsigned_t length)
 {
     Buffer_t *b = (Buffer_t*) memory;
@@ -19,7 +65,7 @@ Buffer_t *InitializeBuffer(Byte_t *memory, Unsigned_t data_width, Unsigned_t len
 
 void *BufferIndex(Buffer_t *b, Unsigned_t idx)
 {
-    assert(idx <= b->length);
+    assert(idx < b->length);
 
     Unsigned_t offset = idx * b->data_width;
     return (void *)&b->data[offset];
@@ -37,26 +83,113 @@ void BufferCopyElement(Buffer_t *b, void *dest, Unsigned_t src_idx)
 
 Buffer_t *BufferClone(Buffer_t *b, Arena_t *a)
 {
-    Buffer_t *new_b = NewBuffer(a, b->data_width, b->length);
-    for (Unsigned_t i = 0; i < b->length; i++)
+    Buffer_t *new_b = ArenaAllocateUninit(a, TOTAL_BUFFER_SIZE(b));
+    new_b->length = b->length;
+    new_b->data_width = b->data_width;
+
+    memcpy(new_b->data, b->data, b->length * b->data_width);
+    return new_b;
+}
+
+/* Check that 'count' elements starting at 'idx' lie within 'length' elements */
+void assert_range(Unsigned_t length, Unsigned_t idx, Unsigned_t count)
+{
+    assert(count <= length && idx <= length - count);
+}
+
+void BufferCopyRange(Buffer_t *dest, Unsigned_t dest_idx, Buffer_t *src, Unsigned_t src_idx, Unsigned_t count)
+{
+    assert(dest->data_width == src->data_width);
+    assert_range(dest->length, dest_idx, count);
+    assert_range(src->length, src_idx, count);
+
+    memcpy(&dest->data[dest_idx * dest->data_width], &src->data[src_idx * src->data_width], count * src->data_width);
+}
+
+void BufferInsertRange(Buffer_t *b, Unsigned_t idx, void *data, Unsigned_t count)
+{
+    assert_range(b->length, idx, count);
+    memcpy(&b->data[idx * b->data_width], data, count * b->data_width);
+}
+
+void BufferMoveRange(Buffer_t *b, Unsigned_t dest_idx, Unsigned_t src_idx, Unsigned_t count)
+{
+    assert_range(b->length, dest_idx, count);
+    assert_range(b->length, src_idx, count);
+
+    memmove(&b->data[dest_idx * b->data_width], &b->data[src_idx * b->data_width], count * b->data_width);
+}
+
+void BufferFill(Buffer_t *b, Unsigned_t idx, Unsigned_t count, void *data)
+{
+    assert_range(b->length, idx, count);
+    if (count == 0)
     {
-        BufferCopyElement(b, BufferIndex(new_b, i), i);
+        return;
     }
 
-    return new_b;
+    Byte_t *start = &b->data[idx * b->data_width];
+    Unsigned_t total = count * b->data_width;
+    if (data == NULL)
+    {
+        memset(start, 0, total);
+        return;
+    }
+    else if (b->data_width == 1)
+    {
+        memset(start, *(Byte_t *)data, total);
+        return;
+    }
+
+    /* Copy in one element, then keep doubling the filled region */
+    memcpy(start, data, b->data_width);
+    for (Unsigned_t filled = b->data_width; filled < total; filled *= 2)
+    {
+        memcpy(start + filled, start, filled < total - filled ? filled : total - filled);
+    }
 }
 
-Unsigned_t RawBufferHash(Byte_t *buff, Unsigned_t length)
+int BufferCompare(Buffer_t *a, Buffer_t *b)
 {
-    Unsigned_t hash = 5381;
+    assert(a->data_width == b->data_width);
 
-    for (Unsigned_t i = 0; i < (length); i++)
+    Unsigned_t length = a->length < b->length ? a->length : b->length;
+    int result = memcmp(a->data, b->data, length * a->data_width);
+    if (result != 0 || a->length == b->length)
     {
-        Byte_t c = buff[i];
-        hash = ((hash << 3) + hash) + c;
+        return result;
     }
 
-    return hash;
+    return a->length < b->length ? -1 : 1;
+}
+
+BufferSlice_t BufferSlice(Buffer_t *b, Unsigned_t idx, Unsigned_t count)
+{
+    assert_range(b->length, idx, count);
+
+    BufferSlice_t slice = {b->data_width, count, &b->data[idx * b->data_width]};
+    return slice;
+}
+
+void *BufferSliceIndex(BufferSlice_t *s, Unsigned_t idx)
+{
+    assert(idx < s->length);
+    return (void *)&s->data[idx * s->data_width];
+}
+
+Buffer_t *BufferSliceClone(BufferSlice_t *s, Arena_t *a)
+{
+    Buffer_t *new_b = ArenaAllocateUninit(a, sizeof(Buffer_t) + (s->length * s->data_width));
+    new_b->length = s->length;
+    new_b->data_width = s->data_width;
+
+    memcpy(new_b->data, s->data, s->length * s->data_width);
+    return new_b;
+}
+
+Unsigned_t RawBufferHash(Byte_t *buff, Unsigned_t length)
+{
+    return RawBufferHashSeeded(buff, length, HASH_DEFAULT_SEED);
 }
 
 Unsigned_t BufferHash(Buffer_t *b)
@@ -84,7 +217,7 @@ void BufferIteratorPrev(BufferItOpaque_t *opaque)
 
 bool BufferIteratorDone(BufferItOpaque_t *opaque)
 {
-    return opaque->cur_idx > opaque->buffer->length;
+    return opaque->cur_idx >= opaque->buffer->length;
 }
 
 void *BufferIteratorItem(BufferItOpaque_t *opaque)
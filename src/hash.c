@@ -0,0 +1,222 @@
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "hash.h"
+
+#define HASH_LANES (HASH_STRIPE_SIZE / sizeof(uint64_t))
+
+static const uint64_t HASH_SECRET[HASH_LANES] = {
+    0xa0761d6478bd642full,
+    0xe7037ed1a0b428dbull,
+    0x8ebc6af09c88c6e3ull,
+    0x589965cc75374cc3ull,
+};
+
+static const uint64_t HASH_SCRAMBLE_PRIME = 0x9e3779b1ull;
+
+/* Multiply two words, and fold the 128-bit product back into one */
+uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+uint64_t hash_read64(Byte_t *p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t hash_read32(Byte_t *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/* Add 'count' stripes to the lanes. Each lane multiplies the two
+ * halves of its word, keyed by the secret, and adds the word itself
+ * so no input bits are lost when a half is zero */
+void accumulate_scalar(uint64_t *lanes, Byte_t *p, Unsigned_t count)
+{
+    for (Unsigned_t s = 0; s < count; s++, p += HASH_STRIPE_SIZE)
+    {
+        for (Unsigned_t i = 0; i < HASH_LANES; i++)
+        {
+            uint64_t data = hash_read64(p + (i * sizeof(uint64_t)));
+            uint64_t keyed = data ^ HASH_SECRET[i];
+            lanes[i] += ((keyed & 0xffffffff) * (keyed >> 32)) + data;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2"))) void accumulate_avx2(uint64_t *lanes, Byte_t *p, Unsigned_t count)
+{
+    __m256i acc = _mm256_loadu_si256((__m256i *)lanes);
+    __m256i secret = _mm256_loadu_si256((__m256i *)HASH_SECRET);
+
+    for (Unsigned_t s = 0; s < count; s++, p += HASH_STRIPE_SIZE)
+    {
+        __m256i data = _mm256_loadu_si256((__m256i *)p);
+        __m256i keyed = _mm256_xor_si256(data, secret);
+        __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+        acc = _mm256_add_epi64(acc, _mm256_add_epi64(product, data));
+    }
+
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+}
+#endif
+
+static void (*accumulate)(uint64_t *lanes, Byte_t *p, Unsigned_t count) = accumulate_scalar;
+
+/* Other targets always use the scalar accumulator */
+__attribute__((constructor)) void select_accumulate()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        accumulate = accumulate_avx2;
+    }
+#endif
+}
+
+/* Spread the high bits of each lane down, so later
+ * multiplies see them */
+void scramble(uint64_t *lanes)
+{
+    for (Unsigned_t i = 0; i < HASH_LANES; i++)
+    {
+        uint64_t lane = lanes[i];
+        lane ^= lane >> 47;
+        lane ^= HASH_SECRET[(i + 1) % HASH_LANES];
+        lanes[i] = lane * HASH_SCRAMBLE_PRIME;
+    }
+}
+
+/* Add 'count' stripes to the lanes, given 'done' stripes have been added
+ * already, scrambling the lanes at the end of every block */
+void consume_stripes(uint64_t *lanes, Unsigned_t done, Byte_t *p, Unsigned_t count)
+{
+    while (count > 0)
+    {
+        Unsigned_t to_block_end = HASH_STRIPES_PER_BLOCK - (done % HASH_STRIPES_PER_BLOCK);
+        Unsigned_t step = count < to_block_end ? count : to_block_end;
+
+        accumulate(lanes, p, step);
+        done += step;
+        count -= step;
+        p += step * HASH_STRIPE_SIZE;
+
+        if (done % HASH_STRIPES_PER_BLOCK == 0)
+        {
+            scramble(lanes);
+        }
+    }
+}
+
+void init_lanes(uint64_t *lanes, Unsigned_t seed)
+{
+    for (Unsigned_t i = 0; i < HASH_LANES; i++)
+    {
+        lanes[i] = seed ^ HASH_SECRET[i];
+    }
+}
+
+/* Fold the lanes, and the 'tail_length' bytes left over after the last
+ * full stripe, into the final hash */
+Unsigned_t finish_hash(uint64_t *lanes, Unsigned_t seed, Unsigned_t length, Byte_t *tail, Unsigned_t tail_length)
+{
+    uint64_t hash = seed ^ hash_mix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+
+    /* Short inputs never touch the lanes */
+    if (length >= HASH_STRIPE_SIZE)
+    {
+        hash ^= hash_mix(lanes[0] ^ HASH_SECRET[1], lanes[1] ^ HASH_SECRET[2]);
+        hash ^= hash_mix(lanes[2] ^ HASH_SECRET[3], lanes[3] ^ HASH_SECRET[0]);
+    }
+
+    while (tail_length > 16)
+    {
+        hash = hash_mix(hash_read64(tail) ^ HASH_SECRET[1], hash_read64(tail + 8) ^ hash);
+        tail += 16;
+        tail_length -= 16;
+    }
+
+    /* Read the last 1-16 bytes as two possibly overlapping words */
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (tail_length >= 4)
+    {
+        Unsigned_t middle = (tail_length >> 3) << 2;
+        a = (hash_read32(tail) << 32) | hash_read32(tail + middle);
+        b = (hash_read32(tail + tail_length - 4) << 32) | hash_read32(tail + tail_length - 4 - middle);
+    }
+    else if (tail_length > 0)
+    {
+        a = ((uint64_t)tail[0] << 16) | ((uint64_t)tail[tail_length >> 1] << 8) | tail[tail_length - 1];
+    }
+
+    hash = hash_mix(a ^ HASH_SECRET[1], b ^ hash);
+    return hash_mix(hash ^ HASH_SECRET[0], length ^ HASH_SECRET[1]);
+}
+
+Unsigned_t RawBufferHashSeeded(Byte_t *buff, Unsigned_t length, Unsigned_t seed)
+{
+    uint64_t lanes[HASH_LANES];
+    Unsigned_t stripes = length / HASH_STRIPE_SIZE;
+
+    init_lanes(lanes, seed);
+    consume_stripes(lanes, 0, buff, stripes);
+
+    Unsigned_t consumed = stripes * HASH_STRIPE_SIZE;
+    return finish_hash(lanes, seed, length, buff + consumed, length - consumed);
+}
+
+void HashStateInit(HashState_t *state, Unsigned_t seed)
+{
+    init_lanes(state->lanes, seed);
+    state->seed = seed;
+    state->length = 0;
+}
+
+void HashStateUpdate(HashState_t *state, Byte_t *data, Unsigned_t length)
+{
+    Unsigned_t pending = state->length % HASH_STRIPE_SIZE;
+    Unsigned_t done = state->length / HASH_STRIPE_SIZE;
+    state->length += length;
+
+    /* Top up a partial stripe left by the last update first */
+    if (pending > 0)
+    {
+        Unsigned_t fill = HASH_STRIPE_SIZE - pending;
+        if (length < fill)
+        {
+            memcpy(state->pending + pending, data, length);
+            return;
+        }
+
+        memcpy(state->pending + pending, data, fill);
+        consume_stripes(state->lanes, done, state->pending, 1);
+        done++;
+        data += fill;
+        length -= fill;
+    }
+
+    Unsigned_t stripes = length / HASH_STRIPE_SIZE;
+    consume_stripes(state->lanes, done, data, stripes);
+
+    Unsigned_t consumed = stripes * HASH_STRIPE_SIZE;
+    memcpy(state->pending, data + consumed, length - consumed);
+}
+
+Unsigned_t HashStateFinal(HashState_t *state)
+{
+    return finish_hash(state->lanes, state->seed, state->length, state->pending, state->length % HASH_STRIPE_SIZE);
+}
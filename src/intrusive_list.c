@@ -0,0 +1,167 @@
+#include "intrusive_list.h"
+
+#include <assert.h>
+
+void InitializeListLink(ListLink_t *link)
+{
+    link->next = link;
+    link->previous = link;
+}
+
+Boolean_t ListLinkIsLinked(ListLink_t *link)
+{
+    return link->next != link;
+}
+
+void ListLinkRemove(ListLink_t *link)
+{
+    link->previous->next = link->next;
+    link->next->previous = link->previous;
+    InitializeListLink(link);
+}
+
+void ListLinkInsertAfter(ListLink_t *position, ListLink_t *link)
+{
+    link->previous = position;
+    link->next = position->next;
+    position->next->previous = link;
+    position->next = link;
+}
+
+void ListLinkInsertBefore(ListLink_t *position, ListLink_t *link)
+{
+    ListLinkInsertAfter(position->previous, link);
+}
+
+void ConstructIntrusiveList(IntrusiveList_t *list)
+{
+    InitializeListLink(&list->sentinel);
+}
+
+Boolean_t IntrusiveListIsEmpty(IntrusiveList_t *list)
+{
+    return list->sentinel.next == &list->sentinel;
+}
+
+void IntrusiveListInsertBack(IntrusiveList_t *list, ListLink_t *link)
+{
+    ListLinkInsertBefore(&list->sentinel, link);
+}
+
+void IntrusiveListInsertFront(IntrusiveList_t *list, ListLink_t *link)
+{
+    ListLinkInsertAfter(&list->sentinel, link);
+}
+
+ListLink_t *IntrusiveListRemoveBack(IntrusiveList_t *list)
+{
+    ListLink_t *link = IntrusiveListLast(list);
+    if (link != NULL)
+    {
+        ListLinkRemove(link);
+    }
+
+    return link;
+}
+
+ListLink_t *IntrusiveListRemoveFront(IntrusiveList_t *list)
+{
+    ListLink_t *link = IntrusiveListFirst(list);
+    if (link != NULL)
+    {
+        ListLinkRemove(link);
+    }
+
+    return link;
+}
+
+ListLink_t *IntrusiveListFirst(IntrusiveList_t *list)
+{
+    return IntrusiveListIsEmpty(list) ? NULL : list->sentinel.next;
+}
+
+ListLink_t *IntrusiveListLast(IntrusiveList_t *list)
+{
+    return IntrusiveListIsEmpty(list) ? NULL : list->sentinel.previous;
+}
+
+ListLink_t *IntrusiveListNext(IntrusiveList_t *list, ListLink_t *link)
+{
+    return link->next == &list->sentinel ? NULL : link->next;
+}
+
+Unsigned_t IntrusiveListLength(IntrusiveList_t *list)
+{
+    Unsigned_t count = 0;
+    for (ListLink_t *link = list->sentinel.next; link != &list->sentinel; link = link->next)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+void IntrusiveListSplice(IntrusiveList_t *dest, IntrusiveList_t *src)
+{
+    assert(dest != src);
+    if (IntrusiveListIsEmpty(src))
+    {
+        return;
+    }
+
+    ListLink_t *first = src->sentinel.next;
+    ListLink_t *last = src->sentinel.previous;
+    ListLink_t *dest_last = dest->sentinel.previous;
+
+    dest_last->next = first;
+    first->previous = dest_last;
+    last->next = &dest->sentinel;
+    dest->sentinel.previous = last;
+
+    InitializeListLink(&src->sentinel);
+}
+
+typedef struct _intrusive_list_iterator_opaque_s
+{
+    ListLink_t *sentinel;
+    ListLink_t *current;
+} IntrusiveListItOpaque_t;
+
+_Static_assert(sizeof(IntrusiveListItOpaque_t) <= IT_OPAQUE_DATA_SIZE, "Intrusive list iterator opaque size too large");
+
+void IntrusiveListIteratorNext(IntrusiveListItOpaque_t *opaque)
+{
+    opaque->current = opaque->current->next;
+}
+
+void IntrusiveListIteratorPrev(IntrusiveListItOpaque_t *opaque)
+{
+    opaque->current = opaque->current->previous;
+}
+
+bool IntrusiveListIteratorDone(IntrusiveListItOpaque_t *opaque)
+{
+    return opaque->current == opaque->sentinel;
+}
+
+void *IntrusiveListIteratorItem(IntrusiveListItOpaque_t *opaque)
+{
+    return opaque->current;
+}
+
+Iterator_t NewIntrusiveListIterator(IntrusiveList_t *list)
+{
+    Iterator_t it = {
+        (IteratorMove_t)IntrusiveListIteratorNext,
+        (IteratorMove_t)IntrusiveListIteratorPrev,
+        (IteratorDone_t)IntrusiveListIteratorDone,
+        (IteratorItem_t)IntrusiveListIteratorItem,
+        NULL,
+    };
+
+    IntrusiveListItOpaque_t *opaque = (IntrusiveListItOpaque_t *)it.opaque_data;
+    opaque->sentinel = &list->sentinel;
+    opaque->current = list->sentinel.next;
+
+    return it;
+}
@@ -5,7 +5,23 @@
 
 ListNode_t *NewListNode(Arena_t *arena, void *data, Unsigned_t length)
 {
-    ListNode_t *new_node = ArenaAllocate(arena, length);
+    /* The data section is about to be overwritten, so don't bother zeroing it */
+    ListNode_t *new_node = data == NULL
+                               ? ArenaAllocate(arena, LIST_NODE_SIZE(length))
+                               : ArenaAllocateUninit(arena, LIST_NODE_SIZE(length));
+
+    new_node->length = length;
+    new_node->previous = new_node;
+    new_node->next = new_node;
+
+    ListNodeWriteData(new_node, data);
+    return new_node;
+}
+
+ListNode_t *NewPooledListNode(Pool_t *pool, void *data, Unsigned_t length)
+{
+    assert(LIST_NODE_SIZE(length) <= pool->slot_size);
+    ListNode_t *new_node = PoolAllocate(pool);
 
     new_node->length = length;
     new_node->previous = new_node;
@@ -23,7 +39,8 @@ void ListNodeWriteData(ListNode_t *ln, void *data)
     }
 }
 
-void ListInsertBack(List_t *list, ListNode_t *new_node)
+/* Link a circle of nodes in at the back of a list, without counting them */
+void list_link_back(List_t *list, ListNode_t *new_node)
 {
     if (list->first_element == NULL)
     {
@@ -44,10 +61,24 @@ void ListInsertBack(List_t *list, ListNode_t *new_node)
     head_new->previous = tail_old;
 }
 
+void ListInsertBack(List_t *list, ListNode_t *new_node)
+{
+    /* 'new_node' may be the head of a circle of nodes, so count all of them */
+    ListNode_t *node = new_node;
+    do
+    {
+        list->length++;
+        node = node->next;
+    } while (node != new_node);
+
+    list_link_back(list, new_node);
+}
+
 ListNode_t *ListRemoveBack(List_t *list)
 {
     assert(list->first_element != NULL);
     ListNode_t *node = list->first_element->previous;
+    list->length--;
 
     if (node == list->first_element)
     {
@@ -59,13 +90,15 @@ ListNode_t *ListRemoveBack(List_t *list)
     list->first_element->previous = node->previous;
     node->previous->next = list->first_element;
 
+    node->next = node;
+    node->previous = node;
     return node;
 }
 
 void ListInsertFront(List_t *list, ListNode_t *new_node)
 {
     ListInsertBack(list, new_node);
-    list->first_element = list->first_element->previous;
+    list->first_element = new_node;
 }
 
 ListNode_t *ListRemoveFront(List_t *list)
@@ -75,36 +108,217 @@ ListNode_t *ListRemoveFront(List_t *list)
     return ListRemoveBack(list);
 }
 
-Unsigned_t ListLength(List_t *list)
+ListNode_t *ListRemoveNode(List_t *list, ListNode_t *node)
 {
-    if (list->first_element == NULL)
+    list->length--;
+    if (node->next == node)
     {
-        return 0;
+        assert(list->first_element == node);
+        list->first_element = NULL;
+        return node;
     }
 
-    ListNode_t *curr = list->first_element;
-    Unsigned_t count = 0;
+    if (list->first_element == node)
+    {
+        list->first_element = node->next;
+    }
+
+    node->previous->next = node->next;
+    node->next->previous = node->previous;
+
+    node->next = node;
+    node->previous = node;
+    return node;
+}
+
+void ListConcat(List_t *dest, List_t *src)
+{
+    if (src->first_element != NULL)
+    {
+        list_link_back(dest, src->first_element);
+        dest->length += src->length;
+        src->first_element = NULL;
+        src->length = 0;
+    }
+}
+
+void ListSplice(List_t *list, ListNode_t *position, List_t *src)
+{
+    ListNode_t *head = src->first_element;
+    if (head == NULL)
+    {
+        return;
+    }
+    list->length += src->length;
+    src->first_element = NULL;
+    src->length = 0;
+
+    if (position == NULL)
+    {
+        /* Linking the chain in before the old first node also puts it at the back, so move the start */
+        list_link_back(list, head);
+        list->first_element = head;
+        return;
+    }
+
+    ListNode_t *tail = head->previous;
+    ListNode_t *after = position->next;
 
+    position->next = head;
+    head->previous = position;
+    tail->next = after;
+    after->previous = tail;
+}
+
+/* The number of nodes from 'node' to the end of a list. Walks forward
+ * from 'node' and back from just before it at the same time, so it
+ * stops after the smaller of the two halves */
+Unsigned_t list_count_from(List_t *list, ListNode_t *node)
+{
+    ListNode_t *head = list->first_element;
+    ListNode_t *forward = node;
+    ListNode_t *backward = node->previous;
+    for (Unsigned_t steps = 1;; steps++)
+    {
+        if (forward->next == head)
+        {
+            return steps;
+        }
+        else if (backward == head)
+        {
+            return list->length - steps;
+        }
+
+        forward = forward->next;
+        backward = backward->previous;
+    }
+}
+
+void ListSplit(List_t *list, ListNode_t *node, List_t *dest)
+{
+    assert(dest->first_element == NULL);
+
+    ListNode_t *head = list->first_element;
+    dest->first_element = node;
+    if (node == head)
+    {
+        dest->length = list->length;
+        list->first_element = NULL;
+        list->length = 0;
+        return;
+    }
+
+    dest->length = list_count_from(list, node);
+    list->length -= dest->length;
+
+    /* Close each half into its own circle */
+    ListNode_t *tail = head->previous;
+    ListNode_t *before = node->previous;
+
+    before->next = head;
+    head->previous = before;
+    tail->next = node;
+    node->previous = tail;
+}
+
+void ListSort(List_t *list, Comparator_t compare)
+{
+    ListNode_t *head = list->first_element;
+    if (head == NULL)
+    {
+        return;
+    }
+
+    /* Sort as a NULL terminated chain, then close it back into a circle */
+    head->previous->next = NULL;
+
+    ListNode_t *tail;
+    Unsigned_t merges;
+    Unsigned_t run = 1;
     do
     {
-        count++;
-        curr = curr->next;
-    } while (curr != list->first_element);
+        /* Merge each pair of neighbouring sorted runs of length 'run' */
+        ListNode_t *left = head;
+        head = NULL;
+        tail = NULL;
+        merges = 0;
+
+        while (left != NULL)
+        {
+            merges++;
+
+            ListNode_t *right = left;
+            Unsigned_t left_size = 0;
+            for (; left_size < run && right != NULL; left_size++)
+            {
+                right = right->next;
+            }
+            Unsigned_t right_size = run;
+
+            while (left_size > 0 || (right_size > 0 && right != NULL))
+            {
+                /* Take from the left on ties, to keep the sort stable */
+                ListNode_t *next;
+                if (left_size > 0 && (right_size == 0 || right == NULL || compare(left->data, right->data) <= 0))
+                {
+                    next = left;
+                    left = left->next;
+                    left_size--;
+                }
+                else
+                {
+                    next = right;
+                    right = right->next;
+                    right_size--;
+                }
+
+                if (tail == NULL)
+                {
+                    head = next;
+                }
+                else
+                {
+                    tail->next = next;
+                }
+                next->previous = tail;
+                tail = next;
+            }
+
+            left = right;
+        }
+
+        tail->next = NULL;
+        run *= 2;
+    } while (merges > 1);
+
+    head->previous = tail;
+    tail->next = head;
+    list->first_element = head;
+}
 
-    return count;
+Unsigned_t ListLength(List_t *list)
+{
+    return list->length;
 }
 
 ListNode_t *ListIndex(List_t *list, Unsigned_t idx)
 {
-    assert(ListLength(list) > idx);
+    assert(idx < list->length);
 
     ListNode_t *curr = list->first_element;
-    Unsigned_t count = 0;
-
-    while (count != idx)
+    if (idx <= list->length / 2)
+    {
+        for (Unsigned_t count = 0; count != idx; count++)
+        {
+            curr = curr->next;
+        }
+    }
+    else
     {
-        count++;
-        curr = curr->next;
+        for (Unsigned_t count = list->length; count != idx; count--)
+        {
+            curr = curr->previous;
+        }
     }
 
     return curr;
@@ -0,0 +1,111 @@
+#include "mpsc_queue.h"
+
+#include <stddef.h>
+
+_Static_assert(offsetof(MpscStub_t, next) == offsetof(ListNode_t, next) &&
+                   offsetof(MpscStub_t, previous) == offsetof(ListNode_t, previous) &&
+                   offsetof(MpscStub_t, length) == offsetof(ListNode_t, length) &&
+                   sizeof(MpscStub_t) == sizeof(ListNode_t),
+               "MpscStub_t must have the layout of a ListNode_t without data");
+
+/* The queue's stub node. Only used as an address, it is never accessed through a ListNode_t */
+ListNode_t *mpsc_stub(MpscQueue_t *q)
+{
+    return (ListNode_t *)(void *)&q->stub;
+}
+
+/* The link to the node after 'node', which is in the stub's own storage when 'node' is the stub */
+ListNode_t **mpsc_next(MpscQueue_t *q, ListNode_t *node)
+{
+    return node == mpsc_stub(q) ? &q->stub.next : &node->next;
+}
+
+void ConstructMpscQueue(MpscQueue_t *q)
+{
+    ListNode_t *stub = mpsc_stub(q);
+    q->stub.next = NULL;
+    q->stub.previous = stub;
+    q->stub.length = 0;
+    q->back = stub;
+    q->front = stub;
+}
+
+void MpscQueuePush(MpscQueue_t *q, ListNode_t *node)
+{
+    __atomic_store_n(mpsc_next(q, node), NULL, __ATOMIC_RELAXED);
+
+    /* Between the exchange and the store, the node is the back of the
+     * queue but not yet reachable from the front. The consumer treats
+     * the queue as empty until the store lands */
+    ListNode_t *previous = __atomic_exchange_n(&q->back, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(mpsc_next(q, previous), node, __ATOMIC_RELEASE);
+}
+
+/* Unlink a popped node, so it can be used like any other standalone list node */
+ListNode_t *popped_node(ListNode_t *node)
+{
+    node->next = node;
+    node->previous = node;
+    return node;
+}
+
+ListNode_t *MpscQueuePop(MpscQueue_t *q)
+{
+    ListNode_t *front = q->front;
+    ListNode_t *next = __atomic_load_n(mpsc_next(q, front), __ATOMIC_ACQUIRE);
+
+    /* Step over the stub */
+    if (front == mpsc_stub(q))
+    {
+        if (next == NULL)
+        {
+            return NULL;
+        }
+
+        q->front = next;
+        front = next;
+        next = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+    }
+
+    if (next != NULL)
+    {
+        q->front = next;
+        return popped_node(front);
+    }
+
+    /* 'front' looks like the last node. If it isn't the back, a push is part way done */
+    if (front != __atomic_load_n(&q->back, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    /* Put the stub behind the last node, so the last node can be taken
+     * without leaving the queue with no nodes */
+    MpscQueuePush(q, mpsc_stub(q));
+
+    next = __atomic_load_n(&front->next, __ATOMIC_ACQUIRE);
+    if (next != NULL)
+    {
+        q->front = next;
+        return popped_node(front);
+    }
+
+    return NULL;
+}
+
+Unsigned_t MpscQueueDrain(MpscQueue_t *q, List_t *dest, Unsigned_t max)
+{
+    Unsigned_t count = 0;
+    for (; count < max; count++)
+    {
+        ListNode_t *node = MpscQueuePop(q);
+        if (node == NULL)
+        {
+            break;
+        }
+
+        ListInsertBack(dest, node);
+    }
+
+    return count;
+}
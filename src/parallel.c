@@ -0,0 +1,433 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallel.h"
+#include "buffer_sort.h"
+#include "alignment.h"
+
+static Unsigned_t thread_count = 0;
+
+/**
+ * @private
+ * The work handed to a single thread. Each task sits on its
+ * own cache line, so threads writing their results do not
+ * contend with each other
+ */
+typedef struct _parallel_task_s
+{
+    Buffer_t *b;
+    Unsigned_t index;
+    Unsigned_t start;
+    Unsigned_t end;
+
+    Comparator_t compare;
+    Predicate_t predicate;
+    void *context;
+    struct _parallel_sort_s *sort;
+    Boolean_t max;
+
+    Unsigned_t count;
+    void *element;
+} ATTRIBUTE_CACHE_ALIGNED ParallelTask_t;
+
+/**
+ * @private
+ * State shared between the threads of a sample sort
+ */
+typedef struct _parallel_sort_s
+{
+    Unsigned_t threads;
+
+    /** counts[(t * threads) + k] is the number of elements thread t puts in bucket k */
+    Unsigned_t *counts;
+
+    /** The bucket each element was put in */
+    Byte_t *buckets;
+
+    /** The 'threads - 1' elements that divide the buckets */
+    Byte_t *splitters;
+
+    /** Where the buckets are gathered before being sorted */
+    Byte_t *sorted;
+} ParallelSort_t;
+
+void SetParallelThreadCount(Unsigned_t threads)
+{
+    __atomic_store_n(&thread_count, threads, __ATOMIC_RELAXED);
+}
+
+/* The number of threads worth splitting 'length' elements between */
+Unsigned_t parallel_threads(Unsigned_t length)
+{
+    Unsigned_t threads = __atomic_load_n(&thread_count, __ATOMIC_RELAXED);
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (Unsigned_t)online : 1;
+    }
+
+    Unsigned_t useful = length / PARALLEL_MIN_CHUNK;
+    threads = threads < useful ? threads : useful;
+    threads = threads < PARALLEL_MAX_THREADS ? threads : PARALLEL_MAX_THREADS;
+    return threads > 0 ? threads : 1;
+}
+
+/* Give each task an even share of the buffer */
+void parallel_split(ParallelTask_t *tasks, Unsigned_t threads, Buffer_t *b)
+{
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        tasks[i] = (ParallelTask_t){.b = b, .index = i};
+        tasks[i].start = (i * b->length) / threads;
+        tasks[i].end = ((i + 1) * b->length) / threads;
+    }
+}
+
+/* Run 'work' on every task, one thread each, and wait for them all to
+ * finish. Tasks whose thread could not be started run on this thread */
+void parallel_run(ParallelTask_t *tasks, Unsigned_t threads, void *(*work)(void *))
+{
+    pthread_t handles[PARALLEL_MAX_THREADS];
+    Boolean_t started[PARALLEL_MAX_THREADS];
+
+    for (Unsigned_t i = 1; i < threads; i++)
+    {
+        started[i] = pthread_create(&handles[i], NULL, work, &tasks[i]) == 0;
+    }
+
+    work(&tasks[0]);
+
+    for (Unsigned_t i = 1; i < threads; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(handles[i], NULL);
+        }
+        else
+        {
+            work(&tasks[i]);
+        }
+    }
+}
+
+/* The number of splitters less than 'element', or not greater than it if 'inclusive' is set */
+Unsigned_t sort_splitter_bound(ParallelSort_t *sort, Unsigned_t width, Comparator_t compare, Byte_t *element,
+                               Boolean_t inclusive)
+{
+    Unsigned_t low = 0;
+    Unsigned_t high = sort->threads - 1;
+    while (low < high)
+    {
+        Unsigned_t middle = low + ((high - low) / 2);
+        if (compare(sort->splitters + (middle * width), element) < (inclusive ? 1 : 0))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/* The bucket the element at 'idx' belongs in. An element equal to some
+ * splitters may go in any of the buckets those splitters bound, so equal
+ * elements are dealt out between them. Otherwise heavily duplicated keys
+ * would all land in one bucket, and be sorted by one thread */
+Unsigned_t sort_bucket(ParallelSort_t *sort, Unsigned_t width, Comparator_t compare, Byte_t *element, Unsigned_t idx)
+{
+    Unsigned_t last = sort_splitter_bound(sort, width, compare, element, true);
+    if (last == 0 || compare(sort->splitters + ((last - 1) * width), element) != 0)
+    {
+        return last;
+    }
+
+    Unsigned_t first = sort_splitter_bound(sort, width, compare, element, false);
+    return first + (idx % (last - first + 1));
+}
+
+void *sort_classify(void *arg)
+{
+    ParallelTask_t *task = arg;
+    ParallelSort_t *sort = task->sort;
+    Unsigned_t width = task->b->data_width;
+
+    /* Count locally, since the rows of other threads share cache lines with ours */
+    Unsigned_t counts[PARALLEL_MAX_THREADS] = {0};
+    for (Unsigned_t i = task->start; i < task->end; i++)
+    {
+        Unsigned_t bucket = sort_bucket(sort, width, task->compare, task->b->data + (i * width), i);
+        sort->buckets[i] = (Byte_t)bucket;
+        counts[bucket]++;
+    }
+
+    memcpy(sort->counts + (task->index * sort->threads), counts, sort->threads * sizeof(Unsigned_t));
+    return NULL;
+}
+
+void *sort_scatter(void *arg)
+{
+    ParallelTask_t *task = arg;
+    ParallelSort_t *sort = task->sort;
+    Unsigned_t width = task->b->data_width;
+
+    Unsigned_t offsets[PARALLEL_MAX_THREADS];
+    memcpy(offsets, sort->counts + (task->index * sort->threads), sort->threads * sizeof(Unsigned_t));
+    for (Unsigned_t i = task->start; i < task->end; i++)
+    {
+        memcpy(sort->sorted + (offsets[sort->buckets[i]]++ * width), task->b->data + (i * width), width);
+    }
+
+    return NULL;
+}
+
+void *sort_bucket_range(void *arg)
+{
+    ParallelTask_t *task = arg;
+    Unsigned_t width = task->b->data_width;
+
+    BufferSlice_t bucket = {width, task->end - task->start, task->sort->sorted + (task->start * width)};
+    BufferSliceSort(&bucket, task->compare);
+    memcpy(task->b->data + (task->start * width), bucket.data, bucket.length * width);
+
+    return NULL;
+}
+
+void BufferParallelSort(Buffer_t *b, Comparator_t compare, Arena_t *scratch)
+{
+    Unsigned_t threads = parallel_threads(b->length);
+    if (threads == 1)
+    {
+        BufferSort(b, compare);
+        return;
+    }
+
+    Unsigned_t width = b->data_width;
+    Unsigned_t samples = threads * PARALLEL_OVERSAMPLE;
+
+    /* Take all of the scratch space at once, so it is simple to give back */
+    Unsigned_t counts_size = AlignInteger(threads * threads * sizeof(Unsigned_t), MACHINE_ALIGNMENT);
+    Unsigned_t sorted_size = AlignInteger(b->length * width, MACHINE_ALIGNMENT);
+    Unsigned_t samples_size = AlignInteger(samples * width, MACHINE_ALIGNMENT);
+    Unsigned_t splitters_size = AlignInteger((threads - 1) * width, MACHINE_ALIGNMENT);
+
+    Boolean_t none = scratch == &ARENA_NONE || scratch->blocks == ((void *)-1);
+    ArenaMark_t mark = {NULL, NULL};
+    if (!none)
+    {
+        mark = ArenaMark(scratch);
+    }
+
+    Byte_t *space = ArenaAllocateUninit(scratch, counts_size + sorted_size + samples_size + splitters_size + b->length);
+    ParallelSort_t sort = {threads, (Unsigned_t *)space};
+    sort.sorted = space + counts_size;
+    Byte_t *sample_data = sort.sorted + sorted_size;
+    sort.splitters = sample_data + samples_size;
+    sort.buckets = sort.splitters + splitters_size;
+    memset(sort.counts, 0, threads * threads * sizeof(Unsigned_t));
+
+    /* Choose splitters from an evenly spaced sample of the buffer */
+    for (Unsigned_t i = 0; i < samples; i++)
+    {
+        Unsigned_t idx = (((2 * i) + 1) * b->length) / (2 * samples);
+        memcpy(sample_data + (i * width), b->data + (idx * width), width);
+    }
+
+    BufferSlice_t sample_slice = {width, samples, sample_data};
+    BufferSliceSort(&sample_slice, compare);
+    for (Unsigned_t k = 0; k < threads - 1; k++)
+    {
+        memcpy(sort.splitters + (k * width), sample_data + ((k + 1) * PARALLEL_OVERSAMPLE * width), width);
+    }
+
+    ParallelTask_t tasks[PARALLEL_MAX_THREADS];
+    parallel_split(tasks, threads, b);
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        tasks[i].compare = compare;
+        tasks[i].sort = &sort;
+    }
+
+    parallel_run(tasks, threads, sort_classify);
+
+    /* Turn the counts into the offset each thread writes each bucket from.
+     * Buckets are laid out in order, and within a bucket, threads are */
+    Unsigned_t bucket_start[PARALLEL_MAX_THREADS + 1];
+    Unsigned_t offset = 0;
+    for (Unsigned_t k = 0; k < threads; k++)
+    {
+        bucket_start[k] = offset;
+        for (Unsigned_t t = 0; t < threads; t++)
+        {
+            Unsigned_t count = sort.counts[(t * threads) + k];
+            sort.counts[(t * threads) + k] = offset;
+            offset += count;
+        }
+    }
+    bucket_start[threads] = offset;
+
+    parallel_run(tasks, threads, sort_scatter);
+
+    /* Each thread now sorts one bucket, and copies it back into place */
+    for (Unsigned_t k = 0; k < threads; k++)
+    {
+        tasks[k].start = bucket_start[k];
+        tasks[k].end = bucket_start[k + 1];
+    }
+
+    parallel_run(tasks, threads, sort_bucket_range);
+
+    if (none)
+    {
+        free(space);
+    }
+    else
+    {
+        ArenaRewind(scratch, mark);
+    }
+}
+
+#define SUM_RANGE(TYPE, TASK)                                       \
+    do                                                              \
+    {                                                               \
+        TYPE *values = (TYPE *)(TASK)->b->data;                     \
+        for (Unsigned_t i = (TASK)->start; i < (TASK)->end; i++)    \
+        {                                                           \
+            (TASK)->count += values[i];                             \
+        }                                                           \
+    } while (0)
+
+void *sum_range(void *arg)
+{
+    ParallelTask_t *task = arg;
+    switch (task->b->data_width)
+    {
+    case 1:
+        SUM_RANGE(uint8_t, task);
+        break;
+    case 2:
+        SUM_RANGE(uint16_t, task);
+        break;
+    case 4:
+        SUM_RANGE(uint32_t, task);
+        break;
+    case 8:
+        SUM_RANGE(uint64_t, task);
+        break;
+    default:
+        assert(false && "Summed elements must be 1, 2, 4 or 8 bytes wide");
+    }
+
+    return NULL;
+}
+
+Unsigned_t BufferParallelSum(Buffer_t *b)
+{
+    ParallelTask_t tasks[PARALLEL_MAX_THREADS];
+    Unsigned_t threads = parallel_threads(b->length);
+    parallel_split(tasks, threads, b);
+    parallel_run(tasks, threads, sum_range);
+
+    Unsigned_t sum = 0;
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        sum += tasks[i].count;
+    }
+
+    return sum;
+}
+
+/* Finds the first smallest element of the range. Maximums are found
+ * by passing the element the other way round to the comparator */
+void *min_range(void *arg)
+{
+    ParallelTask_t *task = arg;
+    Unsigned_t width = task->b->data_width;
+    Byte_t *best = task->start < task->end ? task->b->data + (task->start * width) : NULL;
+    for (Unsigned_t i = task->start + 1; i < task->end; i++)
+    {
+        Byte_t *element = task->b->data + (i * width);
+        if ((task->max ? task->compare(best, element) : task->compare(element, best)) < 0)
+        {
+            best = element;
+        }
+    }
+
+    task->element = best;
+    return NULL;
+}
+
+void *buffer_extreme(Buffer_t *b, Comparator_t compare, Boolean_t max)
+{
+    ParallelTask_t tasks[PARALLEL_MAX_THREADS];
+    Unsigned_t threads = parallel_threads(b->length);
+    parallel_split(tasks, threads, b);
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        tasks[i].compare = compare;
+        tasks[i].max = max;
+    }
+
+    parallel_run(tasks, threads, min_range);
+
+    void *best = tasks[0].element;
+    for (Unsigned_t i = 1; i < threads; i++)
+    {
+        if ((max ? compare(best, tasks[i].element) : compare(tasks[i].element, best)) < 0)
+        {
+            best = tasks[i].element;
+        }
+    }
+
+    return best;
+}
+
+void *BufferParallelMin(Buffer_t *b, Comparator_t compare)
+{
+    return buffer_extreme(b, compare, false);
+}
+
+void *BufferParallelMax(Buffer_t *b, Comparator_t compare)
+{
+    return buffer_extreme(b, compare, true);
+}
+
+void *count_range(void *arg)
+{
+    ParallelTask_t *task = arg;
+    Unsigned_t width = task->b->data_width;
+
+    for (Unsigned_t i = task->start; i < task->end; i++)
+    {
+        task->count += task->predicate(task->b->data + (i * width), task->context);
+    }
+
+    return NULL;
+}
+
+Unsigned_t BufferParallelCountIf(Buffer_t *b, Predicate_t predicate, void *context)
+{
+    ParallelTask_t tasks[PARALLEL_MAX_THREADS];
+    Unsigned_t threads = parallel_threads(b->length);
+    parallel_split(tasks, threads, b);
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        tasks[i].predicate = predicate;
+        tasks[i].context = context;
+    }
+
+    parallel_run(tasks, threads, count_range);
+
+    Unsigned_t count = 0;
+    for (Unsigned_t i = 0; i < threads; i++)
+    {
+        count += tasks[i].count;
+    }
+
+    return count;
+}
@@ -0,0 +1,64 @@
+#include <assert.h>
+
+#include "pool.h"
+#include "alignment.h"
+
+void ConstructPool(Pool_t *pool, Arena_t *arena, Unsigned_t slot_size)
+{
+    ConstructAlignedPool(pool, arena, slot_size, MACHINE_ALIGNMENT);
+}
+
+void ConstructAlignedPool(Pool_t *pool, Arena_t *arena, Unsigned_t slot_size, Unsigned_t alignment)
+{
+    assert(arena != &ARENA_NONE && arena->blocks != ((void *)-1));
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    slot_size = slot_size > sizeof(PoolSlot_t) ? slot_size : sizeof(PoolSlot_t);
+    alignment = alignment > MACHINE_ALIGNMENT ? alignment : MACHINE_ALIGNMENT;
+
+    pool->arena = arena;
+    pool->slot_size = AlignInteger(slot_size, alignment);
+    pool->alignment = alignment;
+    PoolReset(pool);
+}
+
+void PoolReset(Pool_t *pool)
+{
+    pool->free_slots = NULL;
+    pool->slab_next = NULL;
+    pool->slab_end = NULL;
+}
+
+void *PoolAllocate(Pool_t *pool)
+{
+    PoolSlot_t *slot = pool->free_slots;
+    if (slot != NULL)
+    {
+        pool->free_slots = slot->next;
+        return slot;
+    }
+
+    if (pool->slab_next == pool->slab_end)
+    {
+        Unsigned_t slab_size = pool->slot_size > POOL_SLAB_SIZE
+                                   ? pool->slot_size
+                                   : POOL_SLAB_SIZE - (POOL_SLAB_SIZE % pool->slot_size);
+
+        /* Slots are a multiple of the alignment, so aligning the slab aligns them all */
+        pool->slab_next = pool->alignment == MACHINE_ALIGNMENT
+                              ? ArenaAllocateUninit(pool->arena, slab_size)
+                              : ArenaAllocateAligned(pool->arena, slab_size, pool->alignment);
+        pool->slab_end = pool->slab_next + slab_size;
+    }
+
+    void *user_pointer = pool->slab_next;
+    pool->slab_next += pool->slot_size;
+    return user_pointer;
+}
+
+void PoolFree(Pool_t *pool, void *slot)
+{
+    PoolSlot_t *free_slot = slot;
+    free_slot->next = pool->free_slots;
+    pool->free_slots = free_slot;
+}
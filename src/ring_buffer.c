@@ -0,0 +1,126 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "ring_buffer.h"
+
+void ConstructRingBuffer(RingBuffer_t *rb, Arena_t *a, Unsigned_t data_width, Unsigned_t capacity)
+{
+    assert(capacity > 0);
+
+    Unsigned_t length = 1;
+    while (length < capacity)
+    {
+        length <<= 1;
+    }
+
+    rb->arena = a;
+    rb->buffer = NewBuffer(a, data_width, length);
+    rb->mask = length - 1;
+    rb->head = 0;
+    rb->cached_tail = 0;
+    rb->tail = 0;
+    rb->cached_head = 0;
+}
+
+void DeconstructRingBuffer(RingBuffer_t *rb)
+{
+    if (rb->arena == &ARENA_NONE || rb->arena->blocks == ((void *)-1))
+    {
+        free(rb->buffer);
+    }
+
+    rb->buffer = NULL;
+}
+
+/* Copy 'count' elements between 'elements' and the ring, starting at
+ * index 'idx' of the ring. Wrapping past the end takes a second copy */
+void ring_copy(RingBuffer_t *rb, Unsigned_t idx, Byte_t *elements, Unsigned_t count, Boolean_t into_ring)
+{
+    Unsigned_t width = rb->buffer->data_width;
+    Unsigned_t position = idx & rb->mask;
+    Unsigned_t first = rb->buffer->length - position;
+    first = count < first ? count : first;
+
+    Byte_t *ring = &rb->buffer->data[position * width];
+    if (into_ring)
+    {
+        memcpy(ring, elements, first * width);
+        memcpy(rb->buffer->data, elements + (first * width), (count - first) * width);
+    }
+    else
+    {
+        memcpy(elements, ring, first * width);
+        memcpy(elements + (first * width), rb->buffer->data, (count - first) * width);
+    }
+}
+
+/* The number of free slots, as seen by the producer. The consumer's
+ * index is only reloaded when the cached copy says there is not enough room */
+Unsigned_t ring_free(RingBuffer_t *rb, Unsigned_t tail, Unsigned_t wanted)
+{
+    Unsigned_t capacity = rb->mask + 1;
+    if (capacity - (tail - rb->cached_head) < wanted)
+    {
+        rb->cached_head = __atomic_load_n(&rb->head, __ATOMIC_ACQUIRE);
+    }
+
+    return capacity - (tail - rb->cached_head);
+}
+
+/* The number of filled slots, as seen by the consumer */
+Unsigned_t ring_filled(RingBuffer_t *rb, Unsigned_t head, Unsigned_t wanted)
+{
+    if (rb->cached_tail - head < wanted)
+    {
+        rb->cached_tail = __atomic_load_n(&rb->tail, __ATOMIC_ACQUIRE);
+    }
+
+    return rb->cached_tail - head;
+}
+
+Boolean_t RingBufferPush(RingBuffer_t *rb, void *data)
+{
+    return RingBufferPushBatch(rb, data, 1) == 1;
+}
+
+Boolean_t RingBufferPop(RingBuffer_t *rb, void *dest)
+{
+    return RingBufferPopBatch(rb, dest, 1) == 1;
+}
+
+Unsigned_t RingBufferPushBatch(RingBuffer_t *rb, void *data, Unsigned_t count)
+{
+    Unsigned_t tail = __atomic_load_n(&rb->tail, __ATOMIC_RELAXED);
+    Unsigned_t room = ring_free(rb, tail, count);
+    count = count < room ? count : room;
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    ring_copy(rb, tail, data, count, true);
+    __atomic_store_n(&rb->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+Unsigned_t RingBufferPopBatch(RingBuffer_t *rb, void *dest, Unsigned_t count)
+{
+    Unsigned_t head = __atomic_load_n(&rb->head, __ATOMIC_RELAXED);
+    Unsigned_t filled = ring_filled(rb, head, count);
+    count = count < filled ? count : filled;
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    ring_copy(rb, head, dest, count, false);
+    __atomic_store_n(&rb->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+Unsigned_t RingBufferCount(RingBuffer_t *rb)
+{
+    Unsigned_t head = __atomic_load_n(&rb->head, __ATOMIC_ACQUIRE);
+    Unsigned_t tail = __atomic_load_n(&rb->tail, __ATOMIC_ACQUIRE);
+    return tail - head;
+}
@@ -1,5 +1,9 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include "basic_types.h"
 #include "alignment.h"
@@ -10,6 +14,18 @@
 #include "binary_map.h"
 #include "file_iterator.h"
 #include "constant_string.h"
+#include "pool.h"
+#include "dynamic_buffer.h"
+#include "hash.h"
+#include "typed_buffer.h"
+#include "buffer_sort.h"
+#include "parallel.h"
+#include "buffer_search.h"
+#include "ring_buffer.h"
+#include "bounded_queue.h"
+#include "chunked_list.h"
+#include "intrusive_list.h"
+#include "mpsc_queue.h"
 
 static int num_failed;
 static int num_passed;
@@ -91,48 +107,1883 @@ int TestArena()
     return 0;
 }
 
+Unsigned_t count_arena_blocks(Arena_t *a)
+{
+    Unsigned_t num_blocks = 0;
+    for (ArenaBlock_t *b = a->blocks; b != NULL; b = b->next)
+    {
+        num_blocks++;
+    }
+
+    return num_blocks;
+}
+
+int TestArenaGrowth()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Byte_t *last = NULL;
+    for (Unsigned_t i = 0; i < 10000; i++)
+    {
+        Byte_t *value = ArenaAllocate(&a, 16);
+        if ((Unsigned_t)value % MACHINE_ALIGNMENT != 0)
+        {
+            return 1;
+        }
+
+        if (last != NULL && value == last)
+        {
+            return 2;
+        }
+        last = value;
+    }
+
+    Unsigned_t num_blocks = count_arena_blocks(&a);
+
+    /* 10000 small allocations should fit in a handful of geometrically growing blocks */
+    if (num_blocks > 16 || a.current->next != NULL)
+    {
+        return 3;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestArenaUninit()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    for (Unsigned_t i = 1; i < ARENA_BLOCK_SIZE * 4; i *= 3)
+    {
+        Byte_t *dirty = ArenaAllocateUninit(&a, i);
+        memset(dirty, 0xdc, i);
+
+        Byte_t *clean = ArenaAllocate(&a, i);
+        for (Unsigned_t k = 0; k < i; k++)
+        {
+            if (clean[k] != 0)
+            {
+                return 1;
+            }
+        }
+        memset(clean, 0xdc, i);
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestArenaRewind()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Unsigned_t *permanent = ArenaAllocate(&a, sizeof(Unsigned_t));
+    *permanent = 42;
+
+    ArenaMark_t outer = ArenaMark(&a);
+    Unsigned_t num_blocks = 0;
+    for (int round = 0; round < 4; round++)
+    {
+        for (Unsigned_t i = 0; i < 1000; i++)
+        {
+            Byte_t *value = ArenaAllocate(&a, 100);
+            for (Unsigned_t k = 0; k < 100; k++)
+            {
+                if (value[k] != 0)
+                {
+                    return 1;
+                }
+            }
+            memset(value, 0xdc, 100);
+        }
+
+        ArenaMark_t inner = ArenaMark(&a);
+        Byte_t *inner_value = ArenaAllocate(&a, ARENA_BLOCK_SIZE * 8);
+        memset(inner_value, 0xdc, ARENA_BLOCK_SIZE * 8);
+        ArenaRewind(&a, inner);
+
+        if (ArenaAllocate(&a, ARENA_BLOCK_SIZE * 8) != inner_value)
+        {
+            return 2;
+        }
+
+        ArenaRewind(&a, outer);
+
+        /* Every round after the first should reuse the same blocks */
+        if (round == 0)
+        {
+            num_blocks = count_arena_blocks(&a);
+        }
+        else if (num_blocks != count_arena_blocks(&a))
+        {
+            return 3;
+        }
+    }
+
+    if (*permanent != 42)
+    {
+        return 4;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestArenaReset()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Unsigned_t num_blocks = 0;
+    for (int frame = 0; frame < 8; frame++)
+    {
+        for (Unsigned_t i = 0; i < 2000; i++)
+        {
+            Unsigned_t *value = ArenaAllocate(&a, sizeof(Unsigned_t));
+            if (*value != 0)
+            {
+                return 1;
+            }
+            *value = i + 1;
+        }
+
+        if (frame == 0)
+        {
+            num_blocks = count_arena_blocks(&a);
+        }
+        else if (num_blocks != count_arena_blocks(&a))
+        {
+            return 2;
+        }
+
+        ArenaReset(&a);
+        if (a.current != a.blocks || a.blocks->start != (Byte_t *)(a.blocks + 1))
+        {
+            return 3;
+        }
+    }
+
+    ArenaAllocate(&a, ARENA_BLOCK_MAX_SIZE * 2);
+    ArenaResetTrim(&a, ARENA_BLOCK_SIZE * 4);
+    if (count_arena_blocks(&a) >= num_blocks)
+    {
+        return 4;
+    }
+
+    ArenaResetTrim(&a, 0);
+    if (count_arena_blocks(&a) != 1)
+    {
+        return 5;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+#define CONCURRENT_ARENA_THREADS 4
+#define CONCURRENT_ARENA_ALLOCATIONS 20000
+
+typedef struct _concurrent_arena_test_s
+{
+    Arena_t *arena;
+    Unsigned_t id;
+    Unsigned_t *values[CONCURRENT_ARENA_ALLOCATIONS];
+} ConcurrentArenaTest_t;
+
+void *concurrent_arena_worker(void *opaque)
+{
+    ConcurrentArenaTest_t *test = opaque;
+    for (Unsigned_t i = 0; i < CONCURRENT_ARENA_ALLOCATIONS; i++)
+    {
+        Unsigned_t size = i % 97 == 0 ? ARENA_CHUNK_SIZE : sizeof(Unsigned_t) * 2;
+        test->values[i] = ArenaAllocate(test->arena, size);
+        test->values[i][0] = test->id;
+        test->values[i][1] = i;
+    }
+
+    return NULL;
+}
+
+int TestConcurrentArena()
+{
+    Arena_t a;
+    ConstructConcurrentArena(&a);
+
+    static ConcurrentArenaTest_t tests[CONCURRENT_ARENA_THREADS];
+    pthread_t threads[CONCURRENT_ARENA_THREADS];
+    for (Unsigned_t t = 0; t < CONCURRENT_ARENA_THREADS; t++)
+    {
+        tests[t].arena = &a;
+        tests[t].id = t;
+        pthread_create(&threads[t], NULL, concurrent_arena_worker, &tests[t]);
+    }
+
+    for (Unsigned_t t = 0; t < CONCURRENT_ARENA_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    for (Unsigned_t t = 0; t < CONCURRENT_ARENA_THREADS; t++)
+    {
+        for (Unsigned_t i = 0; i < CONCURRENT_ARENA_ALLOCATIONS; i++)
+        {
+            if (tests[t].values[i][0] != t || tests[t].values[i][1] != i)
+            {
+                return 1;
+            }
+        }
+    }
+
+    DeconstructArena(&a);
+
+    /* A new arena at the same address must not reuse the old chunks */
+    ConstructConcurrentArena(&a);
+    Unsigned_t *value = ArenaAllocate(&a, sizeof(Unsigned_t));
+    if (*value != 0 || a.blocks == NULL || (Byte_t *)value < (Byte_t *)a.blocks || (Byte_t *)value >= a.blocks->end)
+    {
+        return 2;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int check_virtual_arena(Arena_t *a, Unsigned_t total)
+{
+    Byte_t *last = NULL;
+    for (Unsigned_t used = 0; used < total; used += 1000)
+    {
+        Byte_t *value = ArenaAllocate(a, 1000);
+        if (last != NULL && value != last + AlignInteger(1000, MACHINE_ALIGNMENT))
+        {
+            return 1;
+        }
+
+        for (Unsigned_t k = 0; k < 1000; k++)
+        {
+            if (value[k] != 0)
+            {
+                return 2;
+            }
+        }
+
+        memset(value, 0xdc, 1000);
+        last = value;
+    }
+
+    return 0;
+}
+
+int TestVirtualArena()
+{
+    Arena_t a;
+    ConstructVirtualArena(&a, 1ul << 30, false);
+
+    if (check_virtual_arena(&a, 8 * 1024 * 1024) != 0)
+    {
+        return 1;
+    }
+
+    ArenaMark_t mark = ArenaMark(&a);
+    Byte_t *marked = ArenaAllocate(&a, 1);
+    ArenaAllocate(&a, ARENA_BLOCK_MAX_SIZE * 4);
+    ArenaRewind(&a, mark);
+    if (ArenaAllocate(&a, 1) != marked)
+    {
+        return 2;
+    }
+
+    /* Trimming keeps whole commits, counted from the first usable byte */
+    Byte_t *data = (Byte_t *)(a.blocks + 1);
+    ArenaResetTrim(&a, a.commit_size * 3 + 1);
+    if (a.blocks->end - data != (ptrdiff_t)(a.commit_size * 4))
+    {
+        return 3;
+    }
+
+    ArenaResetTrim(&a, 0);
+    if (a.blocks->end - data != (ptrdiff_t)a.commit_size || check_virtual_arena(&a, 8 * 1024 * 1024) != 0)
+    {
+        return 3;
+    }
+
+    ArenaReset(&a);
+    if (check_virtual_arena(&a, 1024 * 1024) != 0)
+    {
+        return 4;
+    }
+
+    DeconstructArena(&a);
+
+    ConstructVirtualArena(&a, 1ul << 28, true);
+    if ((Unsigned_t)ArenaAllocate(&a, 1) % ARENA_HUGE_PAGE_SIZE != 0)
+    {
+        return 5;
+    }
+    ArenaReset(&a);
+
+    if (check_virtual_arena(&a, 8 * 1024 * 1024) != 0)
+    {
+        return 6;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+/* Grow and shrink an aligned buffer holding 0 to 99, both in place and after
+ * something else has been allocated behind it. It must stay aligned throughout */
+int check_aligned_buffer_growth(Arena_t *a, Buffer_t *buff)
+{
+    Unsigned_t alignment = a == &ARENA_NONE ? 4096 : CACHE_LINE_SIZE;
+    for (Unsigned_t length = 200; length <= 3200; length *= 2)
+    {
+        Buffer_t *old_buff = buff;
+        buff = ResizeAlignedBuffer(a, buff, length, alignment);
+        if ((Unsigned_t)buff->data % alignment != 0 || buff->length != length ||
+            *(Unsigned_t *)BufferIndex(buff, 99) != 99 || *(Unsigned_t *)BufferIndex(buff, length - 1) != 0)
+        {
+            return 1;
+        }
+
+        /* Nothing is allocated behind the buffer yet, and a virtual arena always has room */
+        if (length == 200 && a->kind == ARENA_VIRTUAL && buff != old_buff)
+        {
+            return 3;
+        }
+
+        if (a != &ARENA_NONE)
+        {
+            ArenaAllocate(a, 24);
+        }
+    }
+
+    buff = ResizeAlignedBuffer(a, buff, 100, alignment);
+    if ((Unsigned_t)buff->data % alignment != 0 || buff->length != 100 || *(Unsigned_t *)BufferIndex(buff, 99) != 99)
+    {
+        return 2;
+    }
+
+    if (a == &ARENA_NONE)
+    {
+        free(buff->data - alignment);
+    }
+
+    return 0;
+}
+
+int TestAlignedAllocation()
+{
+    Arena_t arenas[3];
+    ConstructArena(&arenas[0]);
+    ConstructConcurrentArena(&arenas[1]);
+    ConstructVirtualArena(&arenas[2], 1ul << 30, false);
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (Unsigned_t alignment = 1; alignment <= 8192; alignment *= 2)
+        {
+            ArenaAllocate(&arenas[i], 24);
+            Byte_t *value = ArenaAllocateAligned(&arenas[i], 100, alignment);
+            if ((Unsigned_t)value % alignment != 0 || (Unsigned_t)value % MACHINE_ALIGNMENT != 0)
+            {
+                return 1;
+            }
+            memset(value, 0xdc, 100);
+        }
+
+        Buffer_t *buff = NewAlignedBuffer(&arenas[i], sizeof(Unsigned_t), 100, CACHE_LINE_SIZE);
+        if ((Unsigned_t)buff->data % CACHE_LINE_SIZE != 0 || buff->length != 100 || buff->data_width != sizeof(Unsigned_t))
+        {
+            return 2;
+        }
+
+        for (Unsigned_t k = 0; k < 100; k++)
+        {
+            BufferInsert(buff, k, &k);
+        }
+
+        if (check_aligned_buffer_growth(&arenas[i], buff) != 0)
+        {
+            return 4;
+        }
+    }
+
+    Buffer_t *buff = NewAlignedBuffer(&ARENA_NONE, sizeof(Unsigned_t), 100, 4096);
+    for (Unsigned_t k = 0; k < 100; k++)
+    {
+        BufferInsert(buff, k, &k);
+    }
+
+    if (check_aligned_buffer_growth(&ARENA_NONE, buff) != 0)
+    {
+        return 5;
+    }
+
+    Byte_t *value = ArenaAllocateAligned(&ARENA_NONE, 100, 4096);
+    if ((Unsigned_t)value % 4096 != 0 || value[99] != 0)
+    {
+        return 3;
+    }
+    free(value);
+
+    for (int i = 0; i < 3; i++)
+    {
+        DeconstructArena(&arenas[i]);
+    }
+
+    return 0;
+}
+
+int check_buffer_growth(Arena_t *a, Boolean_t expect_in_place)
+{
+    Buffer_t *buff = NewBuffer(a, sizeof(Unsigned_t), 1);
+    Buffer_t *first = buff;
+    BufferInsert(buff, 0, &(Unsigned_t){0});
+
+    for (Unsigned_t i = 1; i < 5000; i++)
+    {
+        buff = ResizeBuffer(a, buff, i + 1);
+        if (*(Unsigned_t *)BufferIndex(buff, i) != 0)
+        {
+            return 1;
+        }
+
+        BufferInsert(buff, i, &i);
+    }
+
+    if (expect_in_place && buff != first)
+    {
+        return 2;
+    }
+
+    for (Unsigned_t i = 0; i < 5000; i++)
+    {
+        if (*(Unsigned_t *)BufferIndex(buff, i) != i)
+        {
+            return 3;
+        }
+    }
+
+    buff = ResizeBuffer(a, buff, 10);
+    if (buff->length != 10 || *(Unsigned_t *)BufferIndex(buff, 9) != 9)
+    {
+        return 4;
+    }
+
+    if (a == &ARENA_NONE)
+    {
+        free(buff);
+    }
+
+    return 0;
+}
+
+int TestArenaReallocate()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    /* Not the most recent allocation, so must be copied */
+    Unsigned_t *values = ArenaAllocate(&a, sizeof(Unsigned_t) * 4);
+    values[3] = 3;
+    ArenaAllocate(&a, 1);
+    Unsigned_t *moved = ArenaReallocate(&a, values, sizeof(Unsigned_t) * 4, sizeof(Unsigned_t) * 8);
+    if (moved == values || moved[3] != 3 || moved[7] != 0)
+    {
+        return 1;
+    }
+
+    /* The most recent allocation, so grows in place */
+    if (ArenaReallocate(&a, moved, sizeof(Unsigned_t) * 8, sizeof(Unsigned_t) * 16) != moved)
+    {
+        return 2;
+    }
+
+    if (check_buffer_growth(&a, false) != 0)
+    {
+        return 3;
+    }
+
+    DeconstructArena(&a);
+
+    ConstructVirtualArena(&a, 1ul << 30, false);
+    if (check_buffer_growth(&a, true) != 0)
+    {
+        return 4;
+    }
+    DeconstructArena(&a);
+
+    ConstructConcurrentArena(&a);
+    if (check_buffer_growth(&a, false) != 0)
+    {
+        return 5;
+    }
+    DeconstructArena(&a);
+
+    if (check_buffer_growth(&ARENA_NONE, false) != 0)
+    {
+        return 6;
+    }
+
+    return 0;
+}
+
+void *block_cache_worker(void *opaque)
+{
+    Unsigned_t *failed = opaque;
+    for (Unsigned_t round = 0; round < 200; round++)
+    {
+        Arena_t a;
+        ConstructArena(&a);
+
+        for (Unsigned_t i = 0; i < 200; i++)
+        {
+            Byte_t *value = ArenaAllocate(&a, 100);
+            for (Unsigned_t k = 0; k < 100; k++)
+            {
+                *failed |= value[k];
+            }
+            memset(value, 0xdc, 100);
+        }
+
+        DeconstructArena(&a);
+    }
+
+    return NULL;
+}
+
+int TestBlockCache()
+{
+    Arena_t a;
+    ConstructArena(&a);
+    ArenaBlock_t *first = a.blocks;
+    memset(ArenaAllocate(&a, 1000), 0xdc, 1000);
+    DeconstructArena(&a);
+
+    /* The same thread gets its cached block straight back, cleared on allocation */
+    ConstructArena(&a);
+    if (a.blocks != first)
+    {
+        return 1;
+    }
+
+    Byte_t *value = ArenaAllocate(&a, 1000);
+    for (Unsigned_t k = 0; k < 1000; k++)
+    {
+        if (value[k] != 0)
+        {
+            return 2;
+        }
+    }
+    DeconstructArena(&a);
+
+    pthread_t threads[4];
+    Unsigned_t failed[4] = {0};
+    for (Unsigned_t t = 0; t < 4; t++)
+    {
+        pthread_create(&threads[t], NULL, block_cache_worker, &failed[t]);
+    }
+
+    for (Unsigned_t t = 0; t < 4; t++)
+    {
+        pthread_join(threads[t], NULL);
+        if (failed[t] != 0)
+        {
+            return 3;
+        }
+    }
+
+    FlushArenaBlockCache();
+    return 0;
+}
+
+int TestArenaStats()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    for (Unsigned_t i = 0; i < 1000; i++)
+    {
+        ArenaAllocate(&a, 10);
+    }
+
+    ArenaStats_t stats = ArenaStats(&a);
+    if (stats.allocations != 1000 || stats.bytes_requested != 10000 || stats.block_count != count_arena_blocks(&a))
+    {
+        return 1;
+    }
+
+    if (stats.bytes_used < 1000 * AlignInteger(10, MACHINE_ALIGNMENT) ||
+        stats.bytes_used + stats.bytes_wasted > stats.bytes_reserved ||
+        stats.high_water != stats.bytes_used)
+    {
+        return 2;
+    }
+
+    Unsigned_t peak = stats.bytes_used;
+    ArenaReset(&a);
+    ArenaAllocate(&a, 10);
+
+    stats = ArenaStats(&a);
+    /* Allow for the padding needed to align the start of the block */
+    if (stats.high_water != peak || stats.bytes_wasted != 0 ||
+        stats.bytes_used < AlignInteger(10, MACHINE_ALIGNMENT) ||
+        stats.bytes_used >= AlignInteger(10, MACHINE_ALIGNMENT) + MACHINE_ALIGNMENT)
+    {
+        return 4;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
 Unsigned_t TestBuffer()
 {
     Arena_t a;
     ConstructArena(&a);
 
-    Buffer_t *buff = NewBuffer(&a, sizeof(Unsigned_t), 100);
-    for (Unsigned_t i = 0; i < 100; i++)
+    Buffer_t *buff = NewBuffer(&a, sizeof(Unsigned_t), 100);
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        BufferInsert(buff, i, &i);
+    }
+
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        if ((*(Unsigned_t *)BufferIndex(buff, i)) != i)
+        {
+            return i;
+        }
+    }
+
+    Buffer_t *buff2 = BufferClone(buff, &a);
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        if (*(Unsigned_t *)BufferIndex(buff, i) != *(Unsigned_t *)BufferIndex(buff2, i))
+        {
+            return i;
+        }
+    }
+
+    Unsigned_t i = 0;
+    Iterator_t it;
+    for (it = NewBufferIterator(buff2); !IteratorDone(&it); IteratorNext(&it))
+    {
+        Unsigned_t *j = IteratorItem(&it);
+        if (*j != i)
+        {
+            return i;
+        }
+
+        i++;
+    }
+    IteratorClose(&it);
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestBufferRanges()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Unsigned_t values[100];
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        values[i] = i;
+    }
+
+    Buffer_t *buff = NewBuffer(&a, sizeof(Unsigned_t), 100);
+    BufferInsertRange(buff, 0, values, 100);
+
+    Buffer_t *clone = BufferClone(buff, &a);
+    if (BufferCompare(buff, clone) != 0)
+    {
+        return 1;
+    }
+
+    Unsigned_t seven = 7;
+    BufferFill(clone, 10, 33, &seven);
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        Unsigned_t expected = i >= 10 && i < 43 ? 7 : i;
+        if (*(Unsigned_t *)BufferIndex(clone, i) != expected)
+        {
+            return 2;
+        }
+    }
+
+    if (BufferCompare(buff, clone) <= 0 || BufferCompare(clone, buff) >= 0)
+    {
+        return 3;
+    }
+
+    BufferCopyRange(clone, 10, buff, 10, 33);
+    if (BufferCompare(buff, clone) != 0)
+    {
+        return 4;
+    }
+
+    /* Overlapping move towards the end */
+    BufferMoveRange(clone, 5, 0, 50);
+    for (Unsigned_t i = 5; i < 55; i++)
+    {
+        if (*(Unsigned_t *)BufferIndex(clone, i) != i - 5)
+        {
+            return 5;
+        }
+    }
+
+    BufferSlice_t slice = BufferSlice(buff, 20, 30);
+    if (slice.length != 30 || *(Unsigned_t *)BufferSliceIndex(&slice, 29) != 49)
+    {
+        return 6;
+    }
+
+    Buffer_t *from_slice = BufferSliceClone(&slice, &a);
+    Buffer_t *prefix = NewBuffer(&a, sizeof(Unsigned_t), 10);
+    BufferCopyRange(prefix, 0, from_slice, 0, 10);
+    if (from_slice->length != 30 || BufferCompare(prefix, from_slice) >= 0)
+    {
+        return 7;
+    }
+
+    BufferFill(prefix, 0, 10, NULL);
+    if (*(Unsigned_t *)BufferIndex(prefix, 9) != 0)
+    {
+        return 8;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+DEFINE_TYPED_BUFFER(UnsignedBuffer, Unsigned_t)
+
+int TestTypedBuffer()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    UnsignedBuffer_t *ub = NewUnsignedBuffer(&a, 1000);
+    if (ub->data_width != sizeof(Unsigned_t) || ub->length != 1000)
+    {
+        return 1;
+    }
+
+    for (Unsigned_t i = 0; i < ub->length; i++)
+    {
+        UnsignedBufferSet(ub, i, i * 3);
+    }
+
+    Unsigned_t sum = 0;
+    for (Unsigned_t i = 0; i < ub->length; i++)
+    {
+        sum += UnsignedBufferGet(ub, i);
+    }
+
+    if (sum != 3 * (999 * 1000 / 2))
+    {
+        return 2;
+    }
+
+    /* Typed and untyped views see the same elements */
+    Buffer_t *b = UnsignedBufferAsBuffer(ub);
+    if (*(Unsigned_t *)BufferIndex(b, 500) != 1500 || UnsignedBufferIndex(ub, 500) != BufferIndex(b, 500))
+    {
+        return 3;
+    }
+
+    Buffer_t *clone = BufferClone(b, &a);
+    if (UnsignedBufferGet(UnsignedBufferFromBuffer(clone), 999) != 2997)
+    {
+        return 4;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int compare_unsigned(const void *a, const void *b)
+{
+    Unsigned_t x = *(const Unsigned_t *)a;
+    Unsigned_t y = *(const Unsigned_t *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct
+{
+    Unsigned_t key;
+    Unsigned_t order;
+} SortRecord_t;
+
+int compare_record_keys(const void *a, const void *b)
+{
+    return compare_unsigned(&((const SortRecord_t *)a)->key, &((const SortRecord_t *)b)->key);
+}
+
+int check_radix_sort(Arena_t *a, Unsigned_t width, Unsigned_t length)
+{
+    Buffer_t *b = NewBuffer(a, width, length);
+    Buffer_t *expected = NewBuffer(a, sizeof(Unsigned_t), length);
+    for (Unsigned_t i = 0; i < length; i++)
+    {
+        Unsigned_t value = (Unsigned_t)rand() * 2654435761u;
+        memcpy(BufferIndex(b, i), &value, width);
+
+        Unsigned_t key = 0;
+        memcpy(&key, &value, width);
+        BufferInsert(expected, i, &key);
+    }
+
+    BufferRadixSort(b, a);
+    BufferSort(expected, compare_unsigned);
+
+    for (Unsigned_t i = 0; i < length; i++)
+    {
+        Unsigned_t key = 0;
+        memcpy(&key, BufferIndex(b, i), width);
+        if (key != *(Unsigned_t *)BufferIndex(expected, i))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int TestBufferSort()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Unsigned_t lengths[] = {0, 1, 2, 15, 17, 1000, 100000};
+    for (Unsigned_t l = 0; l < sizeof(lengths) / sizeof(Unsigned_t); l++)
+    {
+        Unsigned_t length = lengths[l];
+        Buffer_t *random = NewBuffer(&a, sizeof(Unsigned_t), length);
+        Buffer_t *few = NewBuffer(&a, sizeof(Unsigned_t), length);
+        Buffer_t *descending = NewBuffer(&a, sizeof(Unsigned_t), length);
+        for (Unsigned_t i = 0; i < length; i++)
+        {
+            Unsigned_t value = (Unsigned_t)rand();
+            BufferInsert(random, i, &value);
+            value %= 4;
+            BufferInsert(few, i, &value);
+            value = length - i;
+            BufferInsert(descending, i, &value);
+        }
+
+        Buffer_t *buffers[] = {random, few, descending};
+        for (Unsigned_t k = 0; k < 3; k++)
+        {
+            Buffer_t *stable = BufferClone(buffers[k], &a);
+            BufferSort(buffers[k], compare_unsigned);
+            BufferStableSort(stable, compare_unsigned, &ARENA_NONE);
+            if (BufferCompare(buffers[k], stable) != 0)
+            {
+                return 1;
+            }
+
+            for (Unsigned_t i = 1; i < length; i++)
+            {
+                if (compare_unsigned(BufferIndex(stable, i - 1), BufferIndex(stable, i)) > 0)
+                {
+                    return 2;
+                }
+            }
+        }
+    }
+
+    /* Records with equal keys must keep their original order */
+    Buffer_t *records = NewBuffer(&a, sizeof(SortRecord_t), 5000);
+    for (Unsigned_t i = 0; i < records->length; i++)
+    {
+        SortRecord_t r = {(Unsigned_t)rand() % 50, i};
+        BufferInsert(records, i, &r);
+    }
+
+    ArenaMark_t before = ArenaMark(&a);
+    BufferStableSort(records, compare_record_keys, &a);
+    if (ArenaMark(&a).position != before.position)
+    {
+        return 3;
+    }
+
+    for (Unsigned_t i = 1; i < records->length; i++)
+    {
+        SortRecord_t *prev = BufferIndex(records, i - 1);
+        SortRecord_t *next = BufferIndex(records, i);
+        if (prev->key > next->key || (prev->key == next->key && prev->order > next->order))
+        {
+            return 4;
+        }
+    }
+
+    Unsigned_t widths[] = {1, 2, 4, 8};
+    for (Unsigned_t w = 0; w < 4; w++)
+    {
+        if (check_radix_sort(&a, widths[w], 20000) != 0)
+        {
+            return 5;
+        }
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+Boolean_t is_odd(const void *element, void *context)
+{
+    return (*(const Unsigned_t *)element & 1) != 0;
+}
+
+int TestParallel()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    /* Force several threads, even on a single core machine */
+    SetParallelThreadCount(4);
+
+    /* The last three are heavy in duplicates: few distinct keys, every key
+     * the same, and one key making up nine in ten elements */
+    Unsigned_t lengths[] = {1000, PARALLEL_MIN_CHUNK * 4 + 3, PARALLEL_MIN_CHUNK * 10,
+                            PARALLEL_MIN_CHUNK * 8, PARALLEL_MIN_CHUNK * 8 + 1};
+    for (Unsigned_t l = 0; l < sizeof(lengths) / sizeof(Unsigned_t); l++)
+    {
+        Unsigned_t length = lengths[l];
+        Buffer_t *b = NewBuffer(&a, sizeof(Unsigned_t), length);
+        Unsigned_t sum = 0;
+        Unsigned_t odd = 0;
+        Unsigned_t min = (Unsigned_t)-1;
+        Unsigned_t max = 0;
+        for (Unsigned_t i = 0; i < length; i++)
+        {
+            Unsigned_t value = (Unsigned_t)rand() % (l == 2 ? 10 : RAND_MAX);
+            if (l == 3 || (l == 4 && i % 10 != 0))
+            {
+                value = 42;
+            }
+            BufferInsert(b, i, &value);
+            sum += value;
+            odd += value & 1;
+            min = value < min ? value : min;
+            max = value > max ? value : max;
+        }
+
+        if (BufferParallelSum(b) != sum || BufferParallelCountIf(b, is_odd, NULL) != odd)
+        {
+            return 1;
+        }
+
+        Unsigned_t *found_min = BufferParallelMin(b, compare_unsigned);
+        Unsigned_t *found_max = BufferParallelMax(b, compare_unsigned);
+        if (*found_min != min || *found_max != max)
+        {
+            return 2;
+        }
+
+        Buffer_t *expected = BufferClone(b, &a);
+        BufferRadixSort(expected, &a);
+        BufferParallelSort(b, compare_unsigned, l == 0 ? &ARENA_NONE : &a);
+        if (BufferCompare(b, expected) != 0)
+        {
+            return 3;
+        }
+    }
+
+    Buffer_t *empty = NewBuffer(&a, sizeof(Unsigned_t), 0);
+    if (BufferParallelMin(empty, compare_unsigned) != NULL || BufferParallelSum(empty) != 0)
+    {
+        return 4;
+    }
+
+    SetParallelThreadCount(0);
+    DeconstructArena(&a);
+    return 0;
+}
+
+int check_buffer_search(Arena_t *a, Unsigned_t width, Unsigned_t length)
+{
+    Buffer_t *b = NewBuffer(a, width, length);
+    for (Unsigned_t i = 0; i < length; i++)
+    {
+        BufferFill(b, i, 1, NULL);
+        *(Byte_t *)BufferIndex(b, i) = (Byte_t)(i % 7);
+    }
+
+    /* Values that only match part of an element must not be found */
+    Byte_t value[24] = {0};
+    value[0] = 3;
+    value[width - 1] |= 0x80;
+    if (BufferFind(b, value) != NULL || BufferCount(b, value) != 0)
+    {
+        return 1;
+    }
+
+    value[width - 1] = width == 1 ? 3 : 0;
+    Byte_t *found = BufferFind(b, value);
+    Unsigned_t expected = length > 3 ? (length - 4) / 7 + 1 : 0;
+    if ((length > 3 ? found != BufferIndex(b, 3) : found != NULL) || BufferCount(b, value) != expected)
+    {
+        return 2;
+    }
+
+    return 0;
+}
+
+int TestBufferSearch()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Unsigned_t widths[] = {1, 2, 4, 8, 3, 24};
+    Unsigned_t lengths[] = {0, 3, 4, 31, 100, 1001};
+    for (Unsigned_t w = 0; w < 6; w++)
+    {
+        for (Unsigned_t l = 0; l < 6; l++)
+        {
+            if (check_buffer_search(&a, widths[w], lengths[l]) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+
+    Byte_t text[300] = {0};
+    text[77] = 'x';
+    text[299] = 'x';
+    if (RawByteFind(text, sizeof(text), 'x') != &text[77] || RawByteCount(text, sizeof(text), 'x') != 2 ||
+        RawByteFind(text, 77, 'x') != NULL || RawByteCount(text, sizeof(text), 0) != 298)
+    {
+        return 2;
+    }
+
+    String_t *s = NewString("the quick brown fox jumps over the lazy dog");
+    if (StringFind(s, 'q') != (Character_t *)&s->value[4] || StringCount(s, 'o') != 4 || StringFind(s, '!') != NULL)
+    {
+        return 3;
+    }
+
+    /* Sorted even numbers, so odd keys are never present */
+    Buffer_t *sorted = NewBuffer(&a, sizeof(Unsigned_t), 1000);
+    for (Unsigned_t i = 0; i < sorted->length; i++)
+    {
+        Unsigned_t value = i * 2;
+        BufferInsert(sorted, i, &value);
+    }
+
+    Buffer_t *eytzinger = NewEytzingerBuffer(&a, sorted);
+    for (Unsigned_t key = 0; key <= 2000; key++)
+    {
+        Unsigned_t expected = (key + 1) / 2;
+        Unsigned_t *lower = EytzingerLowerBound(eytzinger, &key, compare_unsigned);
+        if (BufferLowerBound(sorted, &key, compare_unsigned) != expected ||
+            BufferLowerBoundUnsigned(sorted, key) != expected ||
+            (expected == 1000 ? lower != NULL : *lower != expected * 2))
+        {
+            return 4;
+        }
+    }
+
+    Buffer_t *small = NewBuffer(&a, sizeof(uint16_t), 3);
+    uint16_t small_values[] = {5, 10, 15};
+    BufferInsertRange(small, 0, small_values, 3);
+    if (BufferLowerBoundUnsigned(small, 11) != 2 || BufferLowerBoundUnsigned(small, 100000) != 3 ||
+        BufferLowerBoundUnsigned(NewBuffer(&a, 1, 0), 1) != 0)
+    {
+        return 5;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+#define RING_MESSAGES 1000000
+
+void *ring_producer(void *arg)
+{
+    RingBuffer_t *rb = arg;
+    Unsigned_t batch[64];
+    for (Unsigned_t next = 0; next < RING_MESSAGES;)
+    {
+        /* Alternate between single and batched pushes */
+        if (next % 2 == 0)
+        {
+            next += RingBufferPush(rb, &next);
+            continue;
+        }
+
+        Unsigned_t count = RING_MESSAGES - next < 64 ? RING_MESSAGES - next : 64;
+        for (Unsigned_t i = 0; i < count; i++)
+        {
+            batch[i] = next + i;
+        }
+        next += RingBufferPushBatch(rb, batch, count);
+    }
+
+    return NULL;
+}
+
+int TestRingBuffer()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    RingBuffer_t rb;
+    ConstructRingBuffer(&rb, &a, sizeof(Unsigned_t), 5);
+    if (rb.buffer->length != 8 || RingBufferCount(&rb) != 0)
+    {
+        return 1;
+    }
+
+    Unsigned_t values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    Unsigned_t out[10];
+    if (RingBufferPop(&rb, out) || RingBufferPushBatch(&rb, values, 10) != 8 || RingBufferPush(&rb, values))
+    {
+        return 2;
+    }
+
+    /* Pop some, then push past the end of the storage so the batch wraps */
+    if (RingBufferPopBatch(&rb, out, 5) != 5 || RingBufferPushBatch(&rb, values, 4) != 4 || RingBufferCount(&rb) != 7)
+    {
+        return 3;
+    }
+
+    Unsigned_t expected[] = {5, 6, 7, 0, 1, 2, 3};
+    if (RingBufferPopBatch(&rb, out, 10) != 7 || memcmp(out, expected, sizeof(expected)) != 0)
+    {
+        return 4;
+    }
+
+    RingBuffer_t threaded;
+    ConstructRingBuffer(&threaded, &ARENA_NONE, sizeof(Unsigned_t), 1024);
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, ring_producer, &threaded);
+
+    Unsigned_t received = 0;
+    Boolean_t in_order = true;
+    while (received < RING_MESSAGES)
+    {
+        Unsigned_t batch[100];
+        Unsigned_t count = RingBufferPopBatch(&threaded, batch, received % 3 == 0 ? 1 : 100);
+        for (Unsigned_t i = 0; i < count; i++)
+        {
+            in_order &= batch[i] == received + i;
+        }
+        received += count;
+    }
+
+    pthread_join(producer, NULL);
+    DeconstructRingBuffer(&threaded);
+    if (!in_order)
+    {
+        return 5;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+#define QUEUE_THREADS 4
+#define QUEUE_MESSAGES 100000
+
+typedef struct
+{
+    BoundedQueue_t *q;
+    Unsigned_t id;
+    Unsigned_t sum;
+} QueueWorker_t;
+
+void *queue_producer(void *arg)
+{
+    QueueWorker_t *w = arg;
+    for (Unsigned_t i = 1; i <= QUEUE_MESSAGES; i++)
+    {
+        Unsigned_t value = (w->id * QUEUE_MESSAGES) + i;
+        if (i % 2 == 0)
+        {
+            BoundedQueuePush(w->q, &value);
+        }
+        else
+        {
+            while (!BoundedQueueTryPush(w->q, &value))
+            {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void *queue_consumer(void *arg)
+{
+    QueueWorker_t *w = arg;
+    for (Unsigned_t i = 0; i < QUEUE_MESSAGES; i++)
+    {
+        Unsigned_t value;
+        BoundedQueuePop(w->q, &value);
+        w->sum += value;
+    }
+
+    return NULL;
+}
+
+int TestBoundedQueue()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    BoundedQueue_t q;
+    ConstructBoundedQueue(&q, &a, 3, 3);
+    if (q.slots->length != 4)
+    {
+        return 1;
+    }
+
+    Byte_t out[3];
+    Byte_t values[5][3] = {"ab", "cd", "ef", "gh", "ij"};
+    if (BoundedQueueTryPop(&q, out))
+    {
+        return 2;
+    }
+
+    for (Unsigned_t lap = 0; lap < 3; lap++)
+    {
+        for (Unsigned_t i = 0; i < 4; i++)
+        {
+            if (!BoundedQueueTryPush(&q, values[i]))
+            {
+                return 3;
+            }
+        }
+
+        if (BoundedQueueTryPush(&q, values[4]))
+        {
+            return 4;
+        }
+
+        for (Unsigned_t i = 0; i < 4; i++)
+        {
+            if (!BoundedQueueTryPop(&q, out) || memcmp(out, values[i], 3) != 0)
+            {
+                return 5;
+            }
+        }
+
+        if (BoundedQueueTryPop(&q, out))
+        {
+            return 6;
+        }
+    }
+
+    BoundedQueue_t shared;
+    ConstructBoundedQueue(&shared, &ARENA_NONE, sizeof(Unsigned_t), 64);
+
+    pthread_t threads[2 * QUEUE_THREADS];
+    QueueWorker_t workers[2 * QUEUE_THREADS];
+    for (Unsigned_t i = 0; i < 2 * QUEUE_THREADS; i++)
+    {
+        workers[i] = (QueueWorker_t){&shared, i % QUEUE_THREADS, 0};
+        pthread_create(&threads[i], NULL, i < QUEUE_THREADS ? queue_producer : queue_consumer, &workers[i]);
+    }
+
+    Unsigned_t sum = 0;
+    for (Unsigned_t i = 0; i < 2 * QUEUE_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        sum += workers[i].sum;
+    }
+
+    /* Every value from 1 to QUEUE_THREADS * QUEUE_MESSAGES was popped exactly once */
+    Unsigned_t total = QUEUE_THREADS * QUEUE_MESSAGES;
+    DeconstructBoundedQueue(&shared);
+    if (sum != total * (total + 1) / 2)
+    {
+        return 7;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestChunkedList()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    ChunkedList_t list;
+    ConstructChunkedList(&list, &a, sizeof(Unsigned_t));
+    if (ChunkedListLength(&list) != 0 || list.chunk_capacity < 2)
+    {
+        return 1;
+    }
+
+    /* Holds -5000 to 4999, built from both ends */
+    for (Unsigned_t i = 0; i < 5000; i++)
+    {
+        Signed_t back = (Signed_t)i;
+        Signed_t front = -1 - (Signed_t)i;
+        ChunkedListInsertBack(&list, &back);
+        *(Signed_t *)ChunkedListInsertFront(&list, NULL) = front;
+    }
+
+    if (ChunkedListLength(&list) != 10000)
+    {
+        return 2;
+    }
+
+    ListChunk_t *chunk = list.first_chunk;
+    do
+    {
+        if ((Unsigned_t)chunk % CACHE_LINE_SIZE != 0)
+        {
+            return 2;
+        }
+        chunk = chunk->next;
+    } while (chunk != list.first_chunk);
+
+    for (Unsigned_t i = 0; i < 10000; i += 37)
+    {
+        if (*(Signed_t *)ChunkedListIndex(&list, i) != (Signed_t)i - 5000)
+        {
+            return 3;
+        }
+    }
+
+    Signed_t expected = -5000;
+    Iterator_t it;
+    for (it = NewChunkedListIterator(&list); !IteratorDone(&it); IteratorNext(&it))
+    {
+        if (*(Signed_t *)IteratorItem(&it) != expected)
+        {
+            return 4;
+        }
+        expected++;
+    }
+
+    /* Step back from the end onto the last element */
+    IteratorPrevious(&it);
+    if (IteratorDone(&it) || *(Signed_t *)IteratorItem(&it) != 4999)
+    {
+        return 5;
+    }
+    IteratorClose(&it);
+
+    Signed_t removed;
+    for (Unsigned_t i = 0; i < 4000; i++)
+    {
+        ChunkedListRemoveFront(&list, &removed);
+        if (removed != (Signed_t)i - 5000)
+        {
+            return 6;
+        }
+
+        ChunkedListRemoveBack(&list, &removed);
+        if (removed != 4999 - (Signed_t)i)
+        {
+            return 7;
+        }
+    }
+
+    if (ChunkedListLength(&list) != 2000 || *(Signed_t *)ChunkedListIndex(&list, 0) != -1000)
+    {
+        return 8;
+    }
+
+    while (ChunkedListLength(&list) > 0)
+    {
+        ChunkedListRemoveBack(&list, NULL);
+    }
+
+    if (list.first_chunk != NULL)
+    {
+        return 9;
+    }
+
+    /* Emptied chunks are reused rather than allocated again */
+    ArenaMark_t before = ArenaMark(&a);
+    for (Signed_t i = 0; i < 100; i++)
+    {
+        ChunkedListInsertFront(&list, &i);
+    }
+
+    if (ArenaMark(&a).position != before.position || *(Signed_t *)ChunkedListIndex(&list, 99) != 0)
+    {
+        return 10;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+typedef struct
+{
+    Unsigned_t id;
+    ListLink_t all;
+    ListLink_t pending;
+} TestConnection_t;
+
+int TestIntrusiveList()
+{
+    TestConnection_t connections[10];
+    IntrusiveList_t all;
+    IntrusiveList_t pending;
+    IntrusiveList_t done;
+    ConstructIntrusiveList(&all);
+    ConstructIntrusiveList(&pending);
+    ConstructIntrusiveList(&done);
+
+    if (!IntrusiveListIsEmpty(&all) || IntrusiveListRemoveFront(&all) != NULL || IntrusiveListLast(&all) != NULL)
+    {
+        return 1;
+    }
+
+    /* Every connection is on 'all', and the even ones are on 'pending' too */
+    for (Unsigned_t i = 0; i < 10; i++)
+    {
+        connections[i].id = i;
+        InitializeListLink(&connections[i].pending);
+        IntrusiveListInsertBack(&all, &connections[i].all);
+        if (i % 2 == 0)
+        {
+            IntrusiveListInsertFront(&pending, &connections[i].pending);
+        }
+    }
+
+    if (IntrusiveListLength(&all) != 10 || IntrusiveListLength(&pending) != 5 || ListLinkIsLinked(&connections[1].pending))
+    {
+        return 2;
+    }
+
+    Unsigned_t expected = 8;
+    for (ListLink_t *link = IntrusiveListFirst(&pending); link != NULL; link = IntrusiveListNext(&pending, link))
+    {
+        if (LIST_CONTAINER(link, TestConnection_t, pending)->id != expected)
+        {
+            return 3;
+        }
+        expected -= 2;
+    }
+
+    /* Taking a connection off one list leaves it on the other */
+    ListLinkRemove(&connections[4].pending);
+    if (ListLinkIsLinked(&connections[4].pending) || IntrusiveListLength(&pending) != 4 || IntrusiveListLength(&all) != 10)
+    {
+        return 4;
+    }
+
+    ListLinkInsertBefore(&connections[0].pending, &connections[4].pending);
+    ListLinkInsertAfter(&done.sentinel, IntrusiveListRemoveFront(&pending));
+    IntrusiveListSplice(&done, &pending);
+    IntrusiveListSplice(&done, &pending);
+    if (!IntrusiveListIsEmpty(&pending) || IntrusiveListLength(&done) != 5)
+    {
+        return 5;
+    }
+
+    Unsigned_t order[] = {8, 6, 2, 4, 0};
+    Unsigned_t i = 0;
+    for (Iterator_t it = NewIntrusiveListIterator(&done); !IteratorDone(&it); IteratorNext(&it))
+    {
+        if (LIST_CONTAINER(IteratorItem(&it), TestConnection_t, pending)->id != order[i++])
+        {
+            return 6;
+        }
+    }
+
+    if (LIST_CONTAINER(IntrusiveListRemoveBack(&all), TestConnection_t, all)->id != 9 || i != 5)
+    {
+        return 7;
+    }
+
+    return 0;
+}
+
+#define MPSC_PRODUCERS 4
+#define MPSC_MESSAGES 50000
+
+typedef struct
+{
+    MpscQueue_t *q;
+    Unsigned_t id;
+} MpscProducer_t;
+
+void *mpsc_producer(void *arg)
+{
+    MpscProducer_t *p = arg;
+    for (Unsigned_t i = 0; i < MPSC_MESSAGES; i++)
+    {
+        Unsigned_t message[2] = {p->id, i};
+        MpscQueuePush(p->q, NewListNode(&ARENA_NONE, message, sizeof(message)));
+    }
+
+    return NULL;
+}
+
+int TestMpscQueue()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    MpscQueue_t *q = ArenaAllocateAligned(&a, sizeof(MpscQueue_t), CACHE_LINE_SIZE);
+    ConstructMpscQueue(q);
+    if (MpscQueuePop(q) != NULL)
+    {
+        return 1;
+    }
+
+    /* Empty the queue completely several times, so the stub is cycled through */
+    for (Unsigned_t round = 0; round < 3; round++)
+    {
+        for (Unsigned_t i = 0; i < 5; i++)
+        {
+            MpscQueuePush(q, NewListNode(&a, &i, sizeof(Unsigned_t)));
+        }
+
+        for (Unsigned_t i = 0; i < 5; i++)
+        {
+            ListNode_t *node = MpscQueuePop(q);
+            if (node == NULL || *(Unsigned_t *)node->data != i || node->next != node || node->previous != node)
+            {
+                return 2;
+            }
+        }
+
+        if (MpscQueuePop(q) != NULL)
+        {
+            return 3;
+        }
+    }
+
+    pthread_t threads[MPSC_PRODUCERS];
+    MpscProducer_t producers[MPSC_PRODUCERS];
+    for (Unsigned_t i = 0; i < MPSC_PRODUCERS; i++)
+    {
+        producers[i] = (MpscProducer_t){q, i};
+        pthread_create(&threads[i], NULL, mpsc_producer, &producers[i]);
+    }
+
+    /* Messages from each producer must arrive in the order they were sent */
+    Unsigned_t next_expected[MPSC_PRODUCERS] = {0};
+    Unsigned_t received = 0;
+    Boolean_t in_order = true;
+    while (received < MPSC_PRODUCERS * MPSC_MESSAGES)
+    {
+        List_t batch = {NULL};
+        if (MpscQueueDrain(q, &batch, 64) == 0)
+        {
+            sched_yield();
+            continue;
+        }
+
+        while (batch.first_element != NULL)
+        {
+            ListNode_t *node = ListRemoveFront(&batch);
+            Unsigned_t *message = (Unsigned_t *)node->data;
+            in_order &= message[1] == next_expected[message[0]]++;
+            received++;
+            free(node);
+        }
+    }
+
+    for (Unsigned_t i = 0; i < MPSC_PRODUCERS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (!in_order || MpscQueuePop(q) != NULL)
+    {
+        return 4;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+/* Check a list holds exactly 'count' values, in order, walking both ways */
+int check_list_values(List_t *list, Unsigned_t *values, Unsigned_t count)
+{
+    /* The kept count must match the nodes actually linked */
+    Unsigned_t walked = 0;
+    for (ListNode_t *node = list->first_element; node != NULL && (walked == 0 || node != list->first_element);
+         node = node->next)
+    {
+        walked++;
+    }
+
+    if (ListLength(list) != count || walked != count)
+    {
+        return 1;
+    }
+
+    for (Unsigned_t i = 0; i < count; i++)
+    {
+        ListNode_t *node = ListIndex(list, i);
+        if (*(Unsigned_t *)node->data != values[i] || node->next->previous != node || node->previous->next != node)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int TestListSplicing()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    List_t first = {NULL};
+    List_t second = {NULL};
+    ListNode_t *nodes[8];
+    for (Unsigned_t i = 0; i < 8; i++)
     {
-        BufferInsert(buff, i, &i);
+        nodes[i] = NewListNode(&a, &i, sizeof(Unsigned_t));
+        ListInsertBack(i < 4 ? &first : &second, nodes[i]);
     }
 
-    for (Unsigned_t i = 0; i < 100; i++)
+    ListConcat(&first, &second);
+    Unsigned_t all[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    if (second.first_element != NULL || check_list_values(&first, all, 8) != 0)
     {
-        if ((*(Unsigned_t *)BufferIndex(buff, i)) != i)
+        return 1;
+    }
+
+    ListSplit(&first, nodes[5], &second);
+    Unsigned_t low[] = {0, 1, 2, 3, 4};
+    Unsigned_t high[] = {5, 6, 7};
+    if (check_list_values(&first, low, 5) != 0 || check_list_values(&second, high, 3) != 0)
+    {
+        return 2;
+    }
+
+    ListSplice(&first, nodes[1], &second);
+    Unsigned_t middle[] = {0, 1, 5, 6, 7, 2, 3, 4};
+    if (second.first_element != NULL || check_list_values(&first, middle, 8) != 0)
+    {
+        return 3;
+    }
+
+    ListRemoveNode(&first, nodes[0]);
+    ListRemoveNode(&first, nodes[6]);
+    ListRemoveNode(&first, nodes[4]);
+    Unsigned_t removed[] = {1, 5, 7, 2, 3};
+    if (nodes[6]->next != nodes[6] || check_list_values(&first, removed, 5) != 0)
+    {
+        return 4;
+    }
+
+    ListInsertBack(&second, nodes[0]);
+    ListInsertBack(&second, nodes[4]);
+    ListSplice(&first, NULL, &second);
+    Unsigned_t front[] = {0, 4, 1, 5, 7, 2, 3};
+    if (check_list_values(&first, front, 7) != 0)
+    {
+        return 5;
+    }
+
+    ListSplit(&first, first.first_element, &second);
+    ListSplice(&first, NULL, &second);
+    ListSplice(&first, NULL, &second);
+    if (check_list_values(&first, front, 7) != 0)
+    {
+        return 6;
+    }
+
+    /* Split near the front, so most of the list moves */
+    ListSplit(&first, nodes[4], &second);
+    Unsigned_t head[] = {0};
+    Unsigned_t rest[] = {4, 1, 5, 7, 2, 3};
+    if (check_list_values(&first, head, 1) != 0 || check_list_values(&second, rest, 6) != 0)
+    {
+        return 7;
+    }
+
+    ListConcat(&first, &second);
+    if (ListLength(&second) != 0 || check_list_values(&first, front, 7) != 0)
+    {
+        return 7;
+    }
+
+    /* A circle of nodes inserted as one element is counted in full */
+    ListSplit(&first, nodes[5], &second);
+    ListNode_t *chain = second.first_element;
+    second = (List_t){NULL};
+    ListInsertFront(&first, chain);
+    Unsigned_t rotated[] = {5, 7, 2, 3, 0, 4, 1};
+    if (check_list_values(&first, rotated, 7) != 0)
+    {
+        return 8;
+    }
+
+    ListSplit(&first, nodes[0], &second);
+    chain = first.first_element;
+    first = (List_t){NULL};
+    ListInsertBack(&second, chain);
+    if (check_list_values(&second, front, 7) != 0)
+    {
+        return 9;
+    }
+
+    /* Nodes taken off either end can be inserted straight into another list */
+    ListInsertBack(&first, ListRemoveFront(&second));
+    ListInsertFront(&first, ListRemoveBack(&second));
+    Unsigned_t moved[] = {3, 0};
+    Unsigned_t kept[] = {4, 1, 5, 7, 2};
+    if (check_list_values(&first, moved, 2) != 0 || check_list_values(&second, kept, 5) != 0)
+    {
+        return 10;
+    }
+
+    ListConcat(&second, &first);
+    while (second.first_element != NULL)
+    {
+        ListRemoveNode(&second, second.first_element->previous);
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
+int TestListSort()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    List_t empty = {NULL};
+    ListSort(&empty, compare_record_keys);
+
+    Unsigned_t lengths[] = {1, 2, 3, 17, 1000};
+    for (Unsigned_t l = 0; l < sizeof(lengths) / sizeof(Unsigned_t); l++)
+    {
+        List_t list = {NULL};
+        for (Unsigned_t i = 0; i < lengths[l]; i++)
         {
-            return i;
+            SortRecord_t r = {(Unsigned_t)rand() % 10, i};
+            ListInsertBack(&list, NewListNode(&a, &r, sizeof(SortRecord_t)));
+        }
+
+        ListSort(&list, compare_record_keys);
+        if (ListLength(&list) != lengths[l])
+        {
+            return 1;
+        }
+
+        /* Equal keys keep their original order, and every link is consistent */
+        ListNode_t *node = list.first_element;
+        for (Unsigned_t i = 1; i < lengths[l]; i++, node = node->next)
+        {
+            SortRecord_t *prev = (SortRecord_t *)node->data;
+            SortRecord_t *next = (SortRecord_t *)node->next->data;
+            if (prev->key > next->key || (prev->key == next->key && prev->order > next->order) ||
+                node->next->previous != node)
+            {
+                return 2;
+            }
+        }
+
+        if (node->next != list.first_element || list.first_element->previous != node)
+        {
+            return 3;
         }
     }
 
-    Buffer_t *buff2 = BufferClone(buff, &a);
-    for (Unsigned_t i = 0; i < 100; i++)
+    DeconstructArena(&a);
+    return 0;
+}
+
+int check_dynamic_buffer(Arena_t *a)
+{
+    DynamicBuffer_t db;
+    ConstructDynamicBuffer(&db, a, sizeof(Unsigned_t), 0);
+
+    for (Unsigned_t i = 0; i < 10000; i++)
     {
-        if (BufferIndex(buff, i) != BufferIndex(buff2, i))
+        if (*(Unsigned_t *)DynamicBufferPush(&db, &i) != i)
         {
-            return i;
+            return 1;
         }
     }
 
+    if (db.buffer->length != 10000 || db.capacity < 10000)
+    {
+        return 2;
+    }
+
     Unsigned_t i = 0;
     Iterator_t it;
-    for (it = NewBufferIterator(buff2); !IteratorDone(&it); IteratorNext(&it))
+    for (it = NewBufferIterator(db.buffer); !IteratorDone(&it); IteratorNext(&it))
     {
-        Unsigned_t *j = IteratorItem(&it);
-        if (*j != i)
+        if (*(Unsigned_t *)IteratorItem(&it) != i)
         {
-            return i;
+            return 3;
         }
-
         i++;
     }
     IteratorClose(&it);
 
+    if (i != 10000)
+    {
+        return 4;
+    }
+
+    for (Unsigned_t j = 9999; j >= 5000; j--)
+    {
+        Unsigned_t value;
+        DynamicBufferPop(&db, &value);
+        if (value != j)
+        {
+            return 5;
+        }
+    }
+
+    DynamicBufferShrink(&db);
+    if (db.capacity != 5000 || *(Unsigned_t *)BufferIndex(db.buffer, 4999) != 4999)
+    {
+        return 6;
+    }
+
+    /* The buffer is full, so pushing one of its own elements moves it first */
+    if (*(Unsigned_t *)DynamicBufferPush(&db, BufferIndex(db.buffer, 4999)) != 4999)
+    {
+        return 7;
+    }
+
+    if (*(Unsigned_t *)DynamicBufferPush(&db, NULL) != 0)
+    {
+        return 7;
+    }
+
+    DynamicBufferReserve(&db, 20000);
+    if (db.capacity != 20000 || db.buffer->length != 5002)
+    {
+        return 8;
+    }
+
+    DeconstructDynamicBuffer(&db);
+    return 0;
+}
+
+int TestDynamicBuffer()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    if (check_dynamic_buffer(&a) != 0 || check_dynamic_buffer(&ARENA_NONE) != 0)
+    {
+        return 1;
+    }
+
     DeconstructArena(&a);
     return 0;
 }
@@ -277,6 +2128,101 @@ Unsigned_t TestList()
     return 0;
 }
 
+int TestPool()
+{
+    Arena_t a;
+    ConstructArena(&a);
+
+    Pool_t pool;
+    ConstructPool(&pool, &a, LIST_NODE_SIZE(sizeof(Unsigned_t)));
+
+    /* A queue under constant churn should stop growing the arena */
+    List_t queue = {NULL};
+    Unsigned_t next_out = 0;
+    Unsigned_t num_blocks = 0;
+    for (Unsigned_t i = 0; i < 100000; i++)
+    {
+        ListInsertBack(&queue, NewPooledListNode(&pool, &i, sizeof(Unsigned_t)));
+
+        if (i % 3 == 2)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                ListNode_t *node = ListRemoveFront(&queue);
+                if (*(Unsigned_t *)node->data != next_out)
+                {
+                    return 1;
+                }
+
+                next_out++;
+                PoolFree(&pool, node);
+            }
+        }
+
+        if (i == 1000)
+        {
+            num_blocks = count_arena_blocks(&a);
+        }
+    }
+
+    if (count_arena_blocks(&a) != num_blocks)
+    {
+        return 2;
+    }
+
+    Pool_t map_pool;
+    ConstructPool(&map_pool, &a, MAP_NODE_SIZE(sizeof(Unsigned_t)));
+
+    Map_t map = {NULL};
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        InsertMapNode(&map, NewPooledMapNode(&map_pool, i, &i, sizeof(Unsigned_t)));
+    }
+
+    for (Unsigned_t i = 0; i < 100; i++)
+    {
+        if (*(Unsigned_t *)LookupMapValue(&map, i) != i)
+        {
+            return 3;
+        }
+    }
+
+    /* Replacing map entries should reuse the slots of the removed nodes */
+    num_blocks = count_arena_blocks(&a);
+    for (Unsigned_t i = 100; i < 100000; i++)
+    {
+        MapNode_t *removed = RemoveMapNode(&map, i - 100);
+        PoolFree(&map_pool, removed);
+
+        MapNode_t *added = NewPooledMapNode(&map_pool, i, &i, sizeof(Unsigned_t));
+        if (added != removed)
+        {
+            return 4;
+        }
+        InsertMapNode(&map, added);
+    }
+
+    if (count_arena_blocks(&a) != num_blocks || *(Unsigned_t *)LookupMapValue(&map, 99999ul) != 99999)
+    {
+        return 4;
+    }
+
+    /* Once the arena is reset, the pools must start over */
+    ArenaReset(&a);
+    PoolReset(&pool);
+    PoolReset(&map_pool);
+
+    Byte_t *fresh = ArenaAllocate(&a, 1);
+    ListNode_t *node = NewPooledListNode(&pool, &(Unsigned_t){1}, sizeof(Unsigned_t));
+    if ((Byte_t *)node <= fresh || count_arena_blocks(&a) != num_blocks)
+    {
+        return 5;
+    }
+
+    DeconstructArena(&a);
+    return 0;
+}
+
 int check_parent_consistency(MapNode_t *root)
 {
     if (root == NULL)
@@ -365,6 +2311,35 @@ int test_map()
         return 1;
     }
 
+    /* Remove every third key, in an order that hits leaves, inner nodes and the root */
+    for (Unsigned_t i = 0; i < 200; i++)
+    {
+        Unsigned_t key = (i * 7) % 200;
+        if (key % 3 != 0)
+        {
+            continue;
+        }
+
+        MapNode_t *removed = RemoveMapNode(&map, key);
+        if (removed == NULL || removed->key.as_integer != key || check_parent_consistency(map.root) != 0)
+        {
+            return 3;
+        }
+    }
+
+    for (Unsigned_t i = 0; i < 200; i++)
+    {
+        if (ExistsInMap(&map, i) != (i % 3 != 0))
+        {
+            return 3;
+        }
+    }
+
+    if (RemoveMapNode(&map, 0ul) != NULL || RemoveMapNode(&map, 1000ul) != NULL || map.root->parent != NULL)
+    {
+        return 3;
+    }
+
     DeconstructArena(&arena);
     return 0;
 }
@@ -380,6 +2355,25 @@ int test_string_interning()
         return 1;
     }
 
+    /* Enough strings that buckets must hold more than one */
+    String_t *numbers[NUM_INTERN_BUCKETS * 2];
+    for (Unsigned_t i = 0; i < NUM_INTERN_BUCKETS * 2; i++)
+    {
+        char number[32];
+        snprintf(number, sizeof(number), "%lu", i);
+        numbers[i] = NewString(number);
+    }
+
+    for (Unsigned_t i = 0; i < NUM_INTERN_BUCKETS * 2; i++)
+    {
+        char number[32];
+        snprintf(number, sizeof(number), "%lu", i);
+        if (NewString(number) != numbers[i] || numbers[i]->length != strlen(number))
+        {
+            return 6;
+        }
+    }
+
     if (strcmp((char *)hallo->value, (char *)hello->value) != 0)
     {
         return 2;
@@ -401,6 +2395,71 @@ int test_string_interning()
     return 0;
 }
 
+int TestHash()
+{
+    static Byte_t data[3000];
+    for (Unsigned_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (Byte_t)((i * 131) ^ (i >> 3));
+    }
+
+    for (Unsigned_t length = 0; length < sizeof(data); length += 37)
+    {
+        Unsigned_t expected = RawBufferHashSeeded(data, length, 7);
+
+        /* Hashing in uneven pieces must match hashing all at once */
+        HashState_t state;
+        HashStateInit(&state, 7);
+        for (Unsigned_t done = 0, piece = 1; done < length; piece = (piece * 5) % 97 + 1)
+        {
+            Unsigned_t step = length - done < piece ? length - done : piece;
+            HashStateUpdate(&state, data + done, step);
+            done += step;
+        }
+
+        if (HashStateFinal(&state) != expected)
+        {
+            return 1;
+        }
+
+        if (RawBufferHashSeeded(data, length, 8) == expected)
+        {
+            return 2;
+        }
+    }
+
+    if (RawBufferHash(data, 100) != RawBufferHashSeeded(data, 100, HASH_DEFAULT_SEED))
+    {
+        return 3;
+    }
+
+    /* Similar keys should spread evenly over the interning buckets */
+    static Unsigned_t buckets[NUM_INTERN_BUCKETS];
+    for (Unsigned_t i = 0; i < NUM_INTERN_BUCKETS * 8; i++)
+    {
+        char key[32];
+        int length = snprintf(key, sizeof(key), "key_%lu", i);
+        buckets[RawBufferHash((Byte_t *)key, (Unsigned_t)length) % NUM_INTERN_BUCKETS]++;
+    }
+
+    Unsigned_t empty = 0;
+    for (Unsigned_t i = 0; i < NUM_INTERN_BUCKETS; i++)
+    {
+        empty += buckets[i] == 0;
+        if (buckets[i] > 24)
+        {
+            return 4;
+        }
+    }
+
+    if (empty > 4)
+    {
+        return 5;
+    }
+
+    return 0;
+}
+
 int test_file_it()
 {
     Iterator_t it = NewFileIterator("./test_artifacts/test_file.txt");
@@ -447,12 +2506,40 @@ int main()
 {
     TestAlignment();
     TEST(TestArena() == 0, "Arena test")
+    TEST(TestArenaGrowth() == 0, "Arena growth test")
+    TEST(TestArenaUninit() == 0, "Arena uninitialized allocation test")
+    TEST(TestArenaRewind() == 0, "Arena rewind test")
+    TEST(TestArenaReset() == 0, "Arena reset test")
+    TEST(TestConcurrentArena() == 0, "Concurrent arena test")
+    TEST(TestVirtualArena() == 0, "Virtual arena test")
+    TEST(TestAlignedAllocation() == 0, "Aligned allocation test")
+    TEST(TestArenaReallocate() == 0, "Arena reallocate test")
+    TEST(TestBlockCache() == 0, "Block cache test")
+    TEST(TestArenaStats() == 0, "Arena stats test")
     TEST(TestBuffer() == 0, "Buffer testing")
+    TEST(TestBufferRanges() == 0, "Buffer range test")
+    TEST(TestTypedBuffer() == 0, "Typed buffer test")
+    TEST(TestBufferSort() == 0, "Buffer sort test")
+    TEST(TestParallel() == 0, "Parallel buffer test")
+    TEST(TestBufferSearch() == 0, "Buffer search test")
+    TEST(TestRingBuffer() == 0, "Ring buffer test")
+    TEST(TestBoundedQueue() == 0, "Bounded queue test")
+    TEST(TestChunkedList() == 0, "Chunked list test")
+    TEST(TestIntrusiveList() == 0, "Intrusive list test")
+    TEST(TestMpscQueue() == 0, "MPSC queue test")
+    TEST(TestListSplicing() == 0, "List splicing test")
+    TEST(TestListSort() == 0, "List sort test")
+    TEST(TestDynamicBuffer() == 0, "Dynamic buffer test")
     TEST(TestList() == 0, "List test")
+    TEST(TestPool() == 0, "Pool test")
     TEST(test_string_interning() == 0, "String interning")
     TEST(test_map() == 0, "Map test")
     TEST(test_file_it() == 0, "File iterator test")
+    TEST(TestHash() == 0, "Hash test")
 
     printf("Tests Passed: %d\nTests Failed: %d\n", num_passed, num_failed);
+
+    /* Blocks released by the tests stay cached until now */
+    FlushArenaBlockCache();
     return 0;
 }
\ No newline at end of file